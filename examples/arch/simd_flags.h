@@ -17,6 +17,9 @@
         #if defined(__AVX__) && !defined(__FMA__)
             #define __FMA__
         #endif
+        #if defined(__AVX2__) && !defined(__PCLMUL__)
+            #define __PCLMUL__
+        #endif
         #if defined(__SSE4_2__) && !defined(__SSE4_1__)
             #define __SSE4_1__
         #endif
@@ -32,5 +35,8 @@
     #endif
 #elif defined(__ARCH_AARCH64__)
     #define __SIMD_NEON__
+    #if defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO)
+        #define __SIMD_PMULL__
+    #endif
 #else
 #endif
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <cmath>
+#include <vector>
+#include "utility/xoshiro256.h"
+
+// Quantise a received symbol onto the soft decision range of a decoder
+// The ideal symbols ±1 map onto soft_decision_high and soft_decision_low
+template <typename soft_t>
+soft_t quantise_symbol(const float x, const float scale, const soft_t soft_decision_high, const soft_t soft_decision_low) {
+    const float offset = (float(soft_decision_high) + float(soft_decision_low)) / 2.0f;
+    const float magnitude = (float(soft_decision_high) - float(soft_decision_low)) / 2.0f;
+    // Clamp before converting since the noisy value can lie outside the range of soft_t
+    float y = std::round(x*scale*magnitude + offset);
+    if (y > float(soft_decision_high)) y = float(soft_decision_high);
+    if (y < float(soft_decision_low)) y = float(soft_decision_low);
+    return soft_t(y);
+}
+
+// Approximate natural log for positive normal floats with relative error below 1e-7
+// Written without branches or library calls so that loops over it are vectorised
+inline float approx_logf(const float x) {
+    constexpr uint32_t SQRT_HALF_BITS = 0x3F3504F3u;
+    constexpr float LN2 = 0.693147180559945f;
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(float));
+    // x = m*2^e where m lies in [sqrt(0.5),sqrt(2)) so that log(m) is close to 0
+    const int32_t e = int32_t(bits - SQRT_HALF_BITS) >> 23;
+    const uint32_t m_bits = bits - (uint32_t(e) << 23);
+    float m;
+    memcpy(&m, &m_bits, sizeof(float));
+    // log(m) = 2*atanh(s) where s = (m-1)/(m+1) and |s| < 0.172
+    const float s = (m - 1.0f) / (m + 1.0f);
+    const float s2 = s*s;
+    const float p = 1.0f + s2*(1.0f/3.0f + s2*(1.0f/5.0f + s2*(1.0f/7.0f + s2*(1.0f/9.0f))));
+    return float(e)*LN2 + 2.0f*s*p;
+}
+
+/// @brief Approximate sin(2*pi*u) and cos(2*pi*u) for u in [0,1) with absolute error below 1e-7
+inline void approx_sincos_2pi(const float u, float& sin_out, float& cos_out) {
+    constexpr float HALF_PI = 1.57079632679490f;
+    // Reduce to x in [-pi/4,pi/4] around the nearest multiple of pi/2
+    const float v = u*4.0f;
+    const int32_t quadrant = int32_t(v + 0.5f);
+    const float x = (v - float(quadrant)) * HALF_PI;
+    const float x2 = x*x;
+    const float sin_x = x*(1.0f + x2*(-1.0f/6.0f + x2*(1.0f/120.0f + x2*(-1.0f/5040.0f + x2*(1.0f/362880.0f)))));
+    const float cos_x = 1.0f + x2*(-1.0f/2.0f + x2*(1.0f/24.0f + x2*(-1.0f/720.0f + x2*(1.0f/40320.0f))));
+    // Rotate by the quadrant
+    const bool is_swap = (quadrant & 1) != 0;
+    const float sin_sign = (quadrant & 2) ? -1.0f : 1.0f;
+    const float cos_sign = ((quadrant+1) & 2) ? -1.0f : 1.0f;
+    sin_out = sin_sign * (is_swap ? cos_x : sin_x);
+    cos_out = cos_sign * (is_swap ? sin_x : cos_x);
+}
+
+#if defined(__AVX2__)
+inline __m256 approx_logf_avx2(const __m256 x) {
+    const __m256i bits = _mm256_castps_si256(x);
+    const __m256i e = _mm256_srai_epi32(_mm256_sub_epi32(bits, _mm256_set1_epi32(0x3F3504F3)), 23);
+    const __m256 m = _mm256_castsi256_ps(_mm256_sub_epi32(bits, _mm256_slli_epi32(e, 23)));
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 s = _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+    const __m256 s2 = _mm256_mul_ps(s, s);
+    __m256 p = _mm256_set1_ps(1.0f/9.0f);
+    p = _mm256_add_ps(_mm256_mul_ps(p, s2), _mm256_set1_ps(1.0f/7.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s2), _mm256_set1_ps(1.0f/5.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s2), _mm256_set1_ps(1.0f/3.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s2), one);
+    const __m256 log_m = _mm256_mul_ps(_mm256_add_ps(s, s), p);
+    return _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(e), _mm256_set1_ps(0.693147180559945f)), log_m);
+}
+
+inline void approx_sincos_2pi_avx2(const __m256 u, __m256& sin_out, __m256& cos_out) {
+    const __m256 v = _mm256_mul_ps(u, _mm256_set1_ps(4.0f));
+    const __m256i quadrant = _mm256_cvttps_epi32(_mm256_add_ps(v, _mm256_set1_ps(0.5f)));
+    const __m256 x = _mm256_mul_ps(_mm256_sub_ps(v, _mm256_cvtepi32_ps(quadrant)), _mm256_set1_ps(1.57079632679490f));
+    const __m256 x2 = _mm256_mul_ps(x, x);
+    __m256 sin_p = _mm256_set1_ps(1.0f/362880.0f);
+    sin_p = _mm256_add_ps(_mm256_mul_ps(sin_p, x2), _mm256_set1_ps(-1.0f/5040.0f));
+    sin_p = _mm256_add_ps(_mm256_mul_ps(sin_p, x2), _mm256_set1_ps(1.0f/120.0f));
+    sin_p = _mm256_add_ps(_mm256_mul_ps(sin_p, x2), _mm256_set1_ps(-1.0f/6.0f));
+    sin_p = _mm256_add_ps(_mm256_mul_ps(sin_p, x2), _mm256_set1_ps(1.0f));
+    const __m256 sin_x = _mm256_mul_ps(x, sin_p);
+    __m256 cos_x = _mm256_set1_ps(1.0f/40320.0f);
+    cos_x = _mm256_add_ps(_mm256_mul_ps(cos_x, x2), _mm256_set1_ps(-1.0f/720.0f));
+    cos_x = _mm256_add_ps(_mm256_mul_ps(cos_x, x2), _mm256_set1_ps(1.0f/24.0f));
+    cos_x = _mm256_add_ps(_mm256_mul_ps(cos_x, x2), _mm256_set1_ps(-1.0f/2.0f));
+    cos_x = _mm256_add_ps(_mm256_mul_ps(cos_x, x2), _mm256_set1_ps(1.0f));
+    // Rotate by the quadrant, signs are applied by flipping the sign bit
+    const __m256 is_swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+        _mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+    const __m256 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+    const __m256 cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+    sin_out = _mm256_xor_ps(_mm256_blendv_ps(sin_x, cos_x, is_swap), sin_sign);
+    cos_out = _mm256_xor_ps(_mm256_blendv_ps(cos_x, sin_x, is_swap), cos_sign);
+}
+#endif
+
+// Standard normal samples generated with the Box-Muller transform over independent generator lanes
+// Every 32bit word from the generator gives a 24bit uniform, and each pair of uniforms gives a pair of samples
+class NormalGenerator
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 2u*Xoshiro256_Lanes::TOTAL_LANES;
+private:
+    static constexpr size_t N = Xoshiro256_Lanes::TOTAL_LANES;
+    Xoshiro256_Lanes m_rng;
+public:
+    explicit NormalGenerator(const uint64_t seed = 0u): m_rng(seed) {}
+
+    Xoshiro256_Lanes& get_rng() { return m_rng; }
+
+    /// @brief Write the next BLOCK_SIZE samples
+    void generate(float* out) {
+        constexpr float UNIFORM_SCALE = 1.0f / float(1u << 24);
+        alignas(32) uint64_t block[N];
+        alignas(32) uint32_t words[BLOCK_SIZE];
+        m_rng.generate(block);
+        memcpy(words, block, sizeof(block));
+        #if defined(__AVX2__)
+        const __m256i w0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&words[0]));
+        const __m256i w1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&words[N]));
+        const __m256 scale = _mm256_set1_ps(UNIFORM_SCALE);
+        // u0 lies in (0,1) so the log is always finite
+        const __m256 u0 = _mm256_mul_ps(_mm256_add_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(w0, 8)), _mm256_set1_ps(0.5f)), scale);
+        const __m256 u1 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(w1, 8)), scale);
+        const __m256 r = _mm256_sqrt_ps(_mm256_mul_ps(_mm256_set1_ps(-2.0f), approx_logf_avx2(u0)));
+        __m256 sin_u1, cos_u1;
+        approx_sincos_2pi_avx2(u1, sin_u1, cos_u1);
+        _mm256_storeu_ps(&out[0], _mm256_mul_ps(r, cos_u1));
+        _mm256_storeu_ps(&out[N], _mm256_mul_ps(r, sin_u1));
+        #else
+        for (size_t i = 0; i < N; i++) {
+            const float u0 = (float(words[i] >> 8) + 0.5f) * UNIFORM_SCALE;
+            const float u1 = float(words[N+i] >> 8) * UNIFORM_SCALE;
+            const float r = std::sqrt(-2.0f*approx_logf(u0));
+            float sin_u1, cos_u1;
+            approx_sincos_2pi(u1, sin_u1, cos_u1);
+            out[i] = r*cos_u1;
+            out[N+i] = r*sin_u1;
+        }
+        #endif
+    }
+};
+
+// Additive white gaussian noise on BPSK symbols at ±1 for a given Eb/No
+// Noise generation, scaling, quantisation and clamping are fused into a single pass over the symbols
+template <typename soft_t>
+class AWGN_Channel
+{
+private:
+    const soft_t m_soft_decision_high;
+    const soft_t m_soft_decision_low;
+    float m_noise_variance;
+    float m_noisy_signal_norm;
+public:
+    AWGN_Channel(const float EbNo_dB, const size_t code_rate, const soft_t soft_decision_high, const soft_t soft_decision_low)
+    : m_soft_decision_high(soft_decision_high), m_soft_decision_low(soft_decision_low)
+    {
+        const float EsNo_dB = EbNo_dB - 10.0f*std::log10(float(code_rate));
+        // E(X^2) = Var(X) + [E(X)]^2 = Var(X), since E(X) = 0
+        m_noise_variance = std::pow(10.0f, -(EsNo_dB+3.0f)/10.0f); // 3dB for real signal
+        const float noisy_signal_energy = 1.0f + m_noise_variance;
+        m_noisy_signal_norm = 1.0f/std::sqrt(noisy_signal_energy);
+    }
+
+    float get_noise_variance() const { return m_noise_variance; }
+
+    /// @brief Add noise to ideal ±1 symbols and convert them to soft decision values at the receiver
+    void transmit(const float* tx_symbols, soft_t* rx_symbols, const size_t total_symbols, NormalGenerator& noise_gen) const {
+        constexpr size_t BLOCK_SIZE = NormalGenerator::BLOCK_SIZE;
+        const float high = float(m_soft_decision_high);
+        const float low = float(m_soft_decision_low);
+        const float offset = (high + low) / 2.0f;
+        const float gain = m_noisy_signal_norm * (high - low) / 2.0f;
+        const float noise_gain = gain * std::sqrt(m_noise_variance);
+        alignas(32) float noise[BLOCK_SIZE];
+        alignas(32) float y[BLOCK_SIZE];
+        for (size_t i = 0; i < total_symbols; i += BLOCK_SIZE) {
+            noise_gen.generate(noise);
+            const size_t M = ((total_symbols - i) < BLOCK_SIZE) ? (total_symbols - i) : BLOCK_SIZE;
+            const float* tx = &tx_symbols[i];
+            #if defined(__AVX2__)
+            if (M == BLOCK_SIZE) {
+                for (size_t j = 0; j < BLOCK_SIZE; j += 8) {
+                    __m256 v = _mm256_loadu_ps(&tx[j]);
+                    v = _mm256_mul_ps(v, _mm256_set1_ps(gain));
+                    v = _mm256_add_ps(v, _mm256_mul_ps(_mm256_load_ps(&noise[j]), _mm256_set1_ps(noise_gain)));
+                    v = _mm256_floor_ps(_mm256_add_ps(v, _mm256_set1_ps(offset + 0.5f)));
+                    v = _mm256_min_ps(v, _mm256_set1_ps(high));
+                    v = _mm256_max_ps(v, _mm256_set1_ps(low));
+                    _mm256_store_ps(&y[j], v);
+                }
+            } else
+            #endif
+            {
+                for (size_t j = 0; j < M; j++) {
+                    // Clamp before converting since the noisy value can lie outside the range of soft_t
+                    float v = std::floor(tx[j]*gain + noise[j]*noise_gain + (offset + 0.5f));
+                    v = (v > high) ? high : v;
+                    v = (v < low) ? low : v;
+                    y[j] = v;
+                }
+            }
+            soft_t* rx = &rx_symbols[i];
+            for (size_t j = 0; j < M; j++) {
+                rx[j] = soft_t(y[j]);
+            }
+        }
+    }
+};
+
+// Binary symmetric channel which flips the sign of ±1 symbols with a fixed probability
+// This models a hard decision receiver so the output is always at the soft decision limits
+template <typename soft_t>
+class BSC_Channel
+{
+private:
+    const soft_t m_soft_decision_high;
+    const soft_t m_soft_decision_low;
+    // Compared against a random 32bit word
+    uint64_t m_flip_threshold;
+public:
+    BSC_Channel(const float flip_probability, const soft_t soft_decision_high, const soft_t soft_decision_low)
+    : m_soft_decision_high(soft_decision_high), m_soft_decision_low(soft_decision_low)
+    {
+        float p = flip_probability;
+        p = (p < 0.0f) ? 0.0f : p;
+        p = (p > 1.0f) ? 1.0f : p;
+        m_flip_threshold = uint64_t(double(p) * double(uint64_t(1u) << 32));
+    }
+
+    void transmit(const float* tx_symbols, soft_t* rx_symbols, const size_t total_symbols, Xoshiro256_Lanes& rng) const {
+        constexpr size_t BLOCK_SIZE = 2u*Xoshiro256_Lanes::TOTAL_LANES;
+        alignas(32) uint64_t block[Xoshiro256_Lanes::TOTAL_LANES];
+        alignas(32) uint32_t words[BLOCK_SIZE];
+        for (size_t i = 0; i < total_symbols; i += BLOCK_SIZE) {
+            rng.generate(block);
+            memcpy(words, block, sizeof(block));
+            const size_t M = ((total_symbols - i) < BLOCK_SIZE) ? (total_symbols - i) : BLOCK_SIZE;
+            for (size_t j = 0; j < M; j++) {
+                const bool is_high = tx_symbols[i+j] > 0.0f;
+                const bool is_flip = uint64_t(words[j]) < m_flip_threshold;
+                rx_symbols[i+j] = (is_high != is_flip) ? m_soft_decision_high : m_soft_decision_low;
+            }
+        }
+    }
+};
+
+// Captured symbols are stored as raw signed 8bit values where ±127 is an ideal symbol
+// This is the same format as soft decision samples from most software defined radios
+static constexpr float CAPTURED_SYMBOL_MAGNITUDE = 127.0f;
+
+bool load_captured_symbols(const char* filename, std::vector<int8_t>& symbols) {
+    FILE* fp = fopen(filename, "rb");
+    if (fp == nullptr) return false;
+    symbols.clear();
+    int8_t buffer[4096];
+    while (true) {
+        const size_t total_read = fread(buffer, sizeof(int8_t), sizeof(buffer), fp);
+        symbols.insert(symbols.end(), buffer, buffer+total_read);
+        if (total_read < sizeof(buffer)) break;
+    }
+    fclose(fp);
+    return true;
+}
+
+/// @brief Fill the receiver symbols from a capture, wrapping around if the capture is shorter
+template <typename soft_t>
+void replay_captured_symbols(
+    const std::vector<int8_t>& captured_symbols, soft_t* rx_symbols, const size_t N,
+    const soft_t soft_decision_high, const soft_t soft_decision_low)
+{
+    const size_t total_captured = captured_symbols.size();
+    const float scale = 1.0f/CAPTURED_SYMBOL_MAGNITUDE;
+    for (size_t i = 0; i < N; i++) {
+        const float x = float(captured_symbols[i % total_captured]);
+        rx_symbols[i] = quantise_symbol(x, scale, soft_decision_high, soft_decision_low);
+    }
+}
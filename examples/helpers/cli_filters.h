@@ -102,35 +102,43 @@ static std::optional<DecodeType> cli_get_decode_type(const char* arg) {
 
 #define CLI_FILTERS_GETOPT_STRING "c:d:s:l"
 
-static void cli_filters_print_usage() {
-    fprintf(stderr, 
-        "    [-c <code_index> (default: None)]\n");
+// Programs that only accept some of the filters can print usage for the code index or the decode and simd types
+static void cli_filters_print_usage(const bool is_code_filter = true, const bool is_type_filter = true) {
+    if (is_code_filter) {
+        fprintf(stderr, 
+            "    [-c <code_index> (default: None)]\n");
+    }
+
+    if (is_type_filter) {
+        bool is_first = true;
+        fprintf(stderr, 
+            "    [-d <decode_type> (default: None)]\n"
+            "        options: ["
+        );
+        for (const auto& opt: cli_decode_options) {
+            if (!is_first) fprintf(stderr, ",");
+            fprintf(stderr, "%*s", int(opt.arg.size()), opt.arg.c_str());
+            is_first = false;
+        }
+        fprintf(stderr, "]\n");
 
-    bool is_first = true;
-    fprintf(stderr, 
-        "    [-d <decode_type> (default: None)]\n"
-        "        options: ["
-    );
-    for (const auto& opt: cli_decode_options) {
-        if (!is_first) fprintf(stderr, ",");
-        fprintf(stderr, "%*s", int(opt.arg.size()), opt.arg.c_str());
-        is_first = false;
+        fprintf(stderr,
+            "    [-s <simd_type> (default: None)]\n"
+            "        options: ["
+        );
+        is_first = true;
+        for (const auto& opt: cli_simd_options) {
+            if (!is_first) fprintf(stderr, ",");
+            fprintf(stderr, "%*s", int(opt.arg.size()), opt.arg.c_str());
+            is_first = false;
+        };
+        fprintf(stderr, "]\n");
     }
-    fprintf(stderr, "]\n");
 
-    fprintf(stderr,
-        "    [-s <simd_type> (default: None)]\n"
-        "        options: ["
-    );
-    is_first = true;
-    for (const auto& opt: cli_simd_options) {
-        if (!is_first) fprintf(stderr, ",");
-        fprintf(stderr, "%*s", int(opt.arg.size()), opt.arg.c_str());
-        is_first = false;
-    };
-    fprintf(stderr, "]\n");
-    fprintf(stderr, 
-        "    [-l List all available codes ]\n");
+    if (is_code_filter) {
+        fprintf(stderr, 
+            "    [-l List all available codes ]\n");
+    }
 }
 
 enum class CLI_Filters_Getopt_Result {
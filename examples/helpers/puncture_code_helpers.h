@@ -4,7 +4,7 @@
 #include <stddef.h>
 #include <assert.h>
 #include <vector>
-#include "viterbi/convolutional_encoder.h"
+#include "viterbi/convolutional_encoder_templated.h"
 #include "viterbi/viterbi_decoder_core.h"
 #include "utility/basic_ops.h"
 
@@ -13,7 +13,47 @@ struct PuncturedDecodeResult {
     uint64_t accumulated_error = 0;
 };
 
+// Expands punctured symbols back to the mother code by inserting unpunctured values
+// Keeps its position in the puncture code and punctured symbols between reads
+template <typename soft_t, typename input_t>
+struct SymbolDepuncturer {
+    const input_t* punctured_symbols;
+    size_t total_symbols;
+    const bool* puncture_code;
+    size_t puncture_code_length;
+    soft_t unpunctured_symbol_value;
+    size_t index_punctured_symbol = 0;
+    size_t index_puncture_code = 0;
+
+    SymbolDepuncturer(
+        const input_t* _punctured_symbols, const size_t _total_symbols,
+        const bool* _puncture_code, const size_t _puncture_code_length,
+        const soft_t _unpunctured_symbol_value)
+    : punctured_symbols(_punctured_symbols), total_symbols(_total_symbols),
+      puncture_code(_puncture_code), puncture_code_length(_puncture_code_length),
+      unpunctured_symbol_value(_unpunctured_symbol_value) {}
+
+    // Returns the number of symbols written which is less than N if we ran out of punctured symbols
+    size_t read(soft_t* symbols, const size_t N) {
+        for (size_t i = 0u; i < N; i++) {
+            const bool is_punctured = puncture_code[index_puncture_code];
+            if (is_punctured) {
+                if (index_punctured_symbol >= total_symbols) { 
+                    return i;
+                }
+                symbols[i] = soft_t(punctured_symbols[index_punctured_symbol]);
+                index_punctured_symbol++;
+            } else {
+                symbols[i] = unpunctured_symbol_value;
+            }
+            index_puncture_code = ((index_puncture_code+1u) == puncture_code_length) ? 0u : (index_puncture_code+1u);
+        }
+        return N;
+    }
+};
+
 // Reads symbols and depunctured the number of requested symbols
+// Depunctured symbols are pushed in blocks so the requested symbols don't need to be a multiple of the code rate
 template <typename decoder_t, size_t K, size_t R, typename error_t, typename soft_t, typename input_t>
 PuncturedDecodeResult decode_punctured_symbols(
     ViterbiDecoder_Core<K,R,error_t,soft_t>& decoder, 
@@ -22,123 +62,165 @@ PuncturedDecodeResult decode_punctured_symbols(
     const bool* puncture_code, const size_t puncture_code_length,
     const size_t requested_output_symbols)
 {
-    auto symbols = std::vector<soft_t>(R);
+    constexpr size_t BLOCK_SIZE = 256u;
+    soft_t symbols[BLOCK_SIZE];
 
-    size_t index_puncture_code = 0;
+    auto depuncturer = SymbolDepuncturer<soft_t,input_t>(
+        punctured_symbols, total_symbols, 
+        puncture_code, puncture_code_length, 
+        unpunctured_symbol_value);
     size_t index_output_symbol = 0;
     PuncturedDecodeResult res;
 
     while (index_output_symbol < requested_output_symbols) {
-        for (size_t i = 0u; i < R; i++) {
-            soft_t& v = symbols[i];
-            const bool is_punctured = puncture_code[index_puncture_code];
-            if (is_punctured) {
-                // NOTE: If our puncture code is invalid or we request too many symbols
-                //       we may expect a punctured symbol when there isn't one
-                //       Ideally this is caught during development but as a failsafe we exit early
-                assert(res.index_punctured_symbol < total_symbols);
-                if (res.index_punctured_symbol >= total_symbols) { 
-                    return res;
-                }
-                v = soft_t(punctured_symbols[res.index_punctured_symbol]);
-                res.index_punctured_symbol++;
-            } else {
-                v = unpunctured_symbol_value;
-            }
-            index_puncture_code = (index_puncture_code+1) % puncture_code_length;
-            index_output_symbol++;
+        const size_t total_block_symbols = min(requested_output_symbols-index_output_symbol, BLOCK_SIZE);
+        const size_t total_read = depuncturer.read(symbols, total_block_symbols);
+        res.accumulated_error += decoder.template push_symbols<decoder_t, uint64_t>(symbols, total_read);
+        res.index_punctured_symbol = depuncturer.index_punctured_symbol;
+        index_output_symbol += total_read;
+        // NOTE: If our puncture code is invalid or we request too many symbols
+        //       we may expect a punctured symbol when there isn't one
+        //       Ideally this is caught during development but as a failsafe we exit early
+        assert(total_read == total_block_symbols);
+        if (total_read != total_block_symbols) {
+            return res;
         }
-        res.accumulated_error += decoder_t::template update<uint64_t>(decoder, symbols.data(), R);
     }
 
     return res;
 }
 
-template <typename T>
-size_t encode_punctured_data(
-    ConvolutionalEncoder* enc, 
-    const uint8_t* input_bytes, const size_t total_input_bytes,
-    T* output_symbols, const size_t max_output_symbols,
-    const bool* puncture_code, const size_t total_puncture_codes,
-    const T soft_decision_high,
-    const T soft_decision_low) 
+// Puncture code compiled into a mask of transmitted symbols for each input bit
+// The period spans lcm(puncture_code_length, R) symbols so it always starts on an input bit
+class PunctureSchedule 
 {
-    const size_t K = enc->K;
-    const size_t R = enc->R;
-
-    const size_t total_input_bits = total_input_bytes*8;
-    const size_t max_data_symbols = total_input_bits*R;
-
-    size_t curr_output_symbol = 0u;
-    size_t curr_puncture_code = 0u;
-    auto push_symbols = [&](const uint8_t* buf, const size_t total_bits) {
-        for (size_t i = 0u; i < total_bits; i++) {
-            const size_t curr_byte = i / 8;
-            const size_t curr_bit = i % 8;
-            const bool bit = (buf[curr_byte] >> curr_bit) & 0b1;
-            const bool is_punctured = puncture_code[curr_puncture_code];
-            curr_puncture_code = (curr_puncture_code+1) % total_puncture_codes;
-
-            if (is_punctured) {
-                assert(curr_output_symbol < max_output_symbols);
-                output_symbols[curr_output_symbol] = bit ? soft_decision_high : soft_decision_low;
-                curr_output_symbol++;                
+public:
+    const size_t R;
+    std::vector<uint32_t> keep_masks;   // bit j is set if output of generator j is transmitted
+public:
+    PunctureSchedule(const bool* puncture_code, const size_t puncture_code_length, const size_t code_rate)
+    : R(code_rate) 
+    {
+        assert(puncture_code_length > 0u);
+        assert(R <= sizeof(uint32_t)*8u);
+        size_t total_period_symbols = puncture_code_length;
+        while ((total_period_symbols % R) != 0u) {
+            total_period_symbols += puncture_code_length;
+        }
+        const size_t total_period_bits = total_period_symbols / R;
+        keep_masks.resize(total_period_bits);
+        for (size_t i = 0u; i < total_period_bits; i++) {
+            uint32_t mask = 0u;
+            for (size_t j = 0u; j < R; j++) {
+                const bool is_keep = puncture_code[(i*R + j) % puncture_code_length];
+                mask |= uint32_t(is_keep) << j;
             }
+            keep_masks[i] = mask;
         }
-    };
-
-    // encode input bytes
-    auto symbols = std::vector<uint8_t>(R);
-    for (size_t i = 0u; i < total_input_bytes; i++) {
-        const uint8_t x = input_bytes[i];
-        enc->consume_byte(x, symbols.data());
-        push_symbols(symbols.data(), 8u*R);
     }
+};
 
-    return curr_output_symbol;
-}
-
+// Write punctured symbols as soft decision values
 template <typename T>
-size_t encode_punctured_tail(
-    ConvolutionalEncoder* enc, 
-    T* output_symbols, const size_t max_output_symbols,
-    const bool* puncture_code, const size_t total_puncture_codes,
-    const T soft_decision_high,
-    const T soft_decision_low) 
-{
-    const size_t K = enc->K;
-    const size_t R = enc->R;
-
-    const size_t total_tail_bits = K-1;
-    const size_t max_tail_symbols = total_tail_bits*R;
-
-    size_t curr_output_symbol = 0u;
-    size_t curr_puncture_code = 0u;
-    auto push_symbols = [&](const uint8_t* buf, const size_t total_bits) {
-        for (size_t i = 0u; i < total_bits; i++) {
-            const size_t curr_byte = i / 8;
-            const size_t curr_bit = i % 8;
-            const bool bit = (buf[curr_byte] >> curr_bit) & 0b1;
-            const bool is_punctured = puncture_code[curr_puncture_code];
-            curr_puncture_code = (curr_puncture_code+1) % total_puncture_codes;
+struct SoftSymbolSink {
+    T* symbols;
+    size_t max_symbols;
+    T soft_decision_high;
+    T soft_decision_low;
+    size_t total_symbols = 0u;
+
+    SoftSymbolSink(T* _symbols, const size_t _max_symbols, const T _soft_decision_high, const T _soft_decision_low)
+    : symbols(_symbols), max_symbols(_max_symbols), 
+      soft_decision_high(_soft_decision_high), soft_decision_low(_soft_decision_low) {}
+
+    inline void push(const bool bit) {
+        assert(total_symbols < max_symbols);
+        symbols[total_symbols] = bit ? soft_decision_high : soft_decision_low;
+        total_symbols++;
+    }
+};
 
-            if (is_punctured) {
-                assert(curr_output_symbol < max_output_symbols);
-                output_symbols[curr_output_symbol] = bit ? soft_decision_high : soft_decision_low;
-                curr_output_symbol++;                
+// Write punctured symbols as packed bits starting from the least significant bit
+struct PackedBitSink {
+    uint8_t* bytes;
+    size_t max_bits;
+    size_t total_bits = 0u;
+
+    PackedBitSink(uint8_t* _bytes, const size_t _max_bits)
+    : bytes(_bytes), max_bits(_max_bits) {}
+
+    inline void push(const bool bit) {
+        assert(total_bits < max_bits);
+        const size_t curr_byte = total_bits / 8u;
+        const size_t curr_bit = total_bits % 8u;
+        if (curr_bit == 0u) bytes[curr_byte] = 0u;
+        bytes[curr_byte] |= uint8_t(bit) << curr_bit;
+        total_bits++;
+    }
+};
+
+// Streams R words of encoded bits through the schedule starting at index_mask
+template <size_t R, typename sink_t>
+void push_punctured_word(
+    const uint64_t* encoded_bits, const size_t total_bits,
+    const PunctureSchedule& schedule, size_t& index_mask, sink_t& sink) 
+{
+    assert(schedule.R == R);
+    const uint32_t* keep_masks = schedule.keep_masks.data();
+    const size_t total_masks = schedule.keep_masks.size();
+    // NOTE: Keep local copies of the state since writes to char sized symbols may alias them
+    sink_t local_sink = sink;
+    size_t i_mask = index_mask;
+    for (size_t i = 0u; i < total_bits; i++) {
+        const uint32_t mask = keep_masks[i_mask];
+        i_mask = ((i_mask+1u) == total_masks) ? 0u : (i_mask+1u);
+        const size_t shift = 63u - i;
+        for (size_t j = 0u; j < R; j++) {
+            if ((mask >> j) & 0b1) {
+                const bool bit = (encoded_bits[j] >> shift) & uint64_t(1u);
+                local_sink.push(bit);
             }
         }
-    };
-
-    // terminate tail at state 0
-    auto symbols = std::vector<uint8_t>(R);
-    for (size_t i = 0u; i < total_tail_bits; ) {
-        const size_t remain_bits = total_tail_bits-i;
-        const size_t total_bits = min(remain_bits, size_t(8u));
-        enc->consume_byte(0x00, symbols.data());
-        push_symbols(symbols.data(), total_bits*R);
-        i += total_bits;
     }
+    sink = local_sink;
+    index_mask = i_mask;
+}
+
+// Fused encoder, puncturer and symbol mapper
+// Puncture schedule starts from the beginning on each call
+template <size_t K, size_t R, typename sink_t>
+void encode_punctured_data(
+    ConvolutionalEncoderT<K,R>& enc,
+    const uint8_t* input_bytes, const size_t total_input_bytes,
+    const PunctureSchedule& schedule, sink_t& sink) 
+{
+    constexpr size_t TOTAL_WORD_BITS = 64u;
+    constexpr size_t TOTAL_WORD_BYTES = TOTAL_WORD_BITS/8u;
+    uint64_t encoded_bits[R];
+    size_t index_mask = 0u;
+
+    for (size_t curr_byte = 0u; curr_byte < total_input_bytes; curr_byte += TOTAL_WORD_BYTES) {
+        const size_t total_bytes = min(total_input_bytes-curr_byte, TOTAL_WORD_BYTES);
+        // Big endian so first bit transmitted is most significant bit
+        uint64_t word = 0u;
+        for (size_t i = 0u; i < total_bytes; i++) {
+            word |= uint64_t(input_bytes[curr_byte+i]) << (TOTAL_WORD_BITS-8u-i*8u);
+        }
+        enc.encode_word(word, total_bytes*8u, encoded_bits);
+        push_punctured_word<R>(encoded_bits, total_bytes*8u, schedule, index_mask, sink);
+    }
+}
 
-    return curr_output_symbol;
-}
\ No newline at end of file
+// Terminate tail at state 0 
+// Puncture schedule starts from the beginning
+template <size_t K, size_t R, typename sink_t>
+void encode_punctured_tail(
+    ConvolutionalEncoderT<K,R>& enc,
+    const PunctureSchedule& schedule, sink_t& sink)
+{
+    constexpr size_t total_tail_bits = K-1u;
+    uint64_t encoded_bits[R];
+    size_t index_mask = 0u;
+    enc.encode_word(0u, total_tail_bits, encoded_bits);
+    push_punctured_word<R>(encoded_bits, total_tail_bits, schedule, index_mask, sink);
+}
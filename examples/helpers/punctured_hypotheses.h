@@ -0,0 +1,127 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include "viterbi/viterbi_decoder_core.h"
+#include "./puncture_code_helpers.h"
+#include "utility/basic_ops.h"
+
+// Candidate alignment of a received punctured stream
+// symbol_offset = number of received symbols to skip before the first symbol of the frame
+// puncture_phase = index into the puncture code of the first symbol of the frame
+struct PunctureHypothesis {
+    size_t symbol_offset = 0;
+    size_t puncture_phase = 0;
+};
+
+struct PunctureHypothesisResult {
+    size_t index = 0;                   // index into the list of hypotheses
+    uint64_t error = 0;                 // accumulated error of the best path without the cost of the erasures
+    size_t total_decoded_bits = 0;
+    size_t total_erasures = 0;          // number of punctured symbols filled in with the unpunctured symbol value
+    bool is_complete = false;           // false if the received symbols ran out before total_decoded_bits
+};
+
+// Decodes every hypothesis for total_decoded_bits and ranks them from most to least likely
+// Incomplete hypotheses are ranked last, then by ascending path error, then by their index
+// All hypotheses are advanced in lockstep blocks so they read the same region of the received symbols
+// while it is still in cache, and the hypotheses are split between total_threads threads
+// Hypotheses should decode the same number of bits for their path errors to be comparable
+// Every branch pays the same cost for an erasure when the unpunctured symbol value is halfway between the soft decision
+// values, so that cost is subtracted from the path error of each hypothesis. Otherwise hypotheses whose windows
+// contain fewer erasures would be favoured regardless of how well their received symbols fit the code.
+template <class decoder_t, size_t K, size_t R, typename error_t, typename soft_t, typename input_t>
+std::vector<PunctureHypothesisResult> decode_punctured_hypotheses(
+    const ViterbiBranchTable<K,R,soft_t>& branch_table,
+    const ViterbiDecoder_Config<error_t>& config,
+    const soft_t unpunctured_symbol_value,
+    const input_t* punctured_symbols, const size_t total_symbols,
+    const bool* puncture_code, const size_t puncture_code_length,
+    const PunctureHypothesis* hypotheses, const size_t total_hypotheses,
+    const size_t total_decoded_bits,
+    const size_t total_threads = 1u)
+{
+    using core_t = ViterbiDecoder_Core<K,R,error_t,soft_t>;
+    using depuncturer_t = SymbolDepuncturer<soft_t,input_t>;
+    constexpr size_t BLOCK_SIZE = 256u;
+    assert(total_threads >= 1u);
+    const size_t total_output_symbols = total_decoded_bits*R;
+    // The erasure cost would depend on the branch if the unpunctured symbol value wasn't halfway
+    assert((int64_t(branch_table.get_soft_decision_high()) + int64_t(branch_table.get_soft_decision_low())) == 2*int64_t(unpunctured_symbol_value));
+    const uint64_t erasure_error = uint64_t(int64_t(branch_table.get_soft_decision_high()) - int64_t(unpunctured_symbol_value));
+
+    std::vector<std::unique_ptr<core_t>> decoders;
+    std::vector<depuncturer_t> depuncturers;
+    std::vector<PunctureHypothesisResult> results;
+    decoders.reserve(total_hypotheses);
+    depuncturers.reserve(total_hypotheses);
+    results.resize(total_hypotheses);
+    for (size_t i = 0u; i < total_hypotheses; i++) {
+        const auto& hypothesis = hypotheses[i];
+        assert(hypothesis.puncture_phase < puncture_code_length);
+        auto decoder = std::make_unique<core_t>(branch_table, config);
+        decoder->set_traceback_length(total_decoded_bits);
+        decoder->reset();
+        decoders.push_back(std::move(decoder));
+
+        const size_t symbol_offset = min(hypothesis.symbol_offset, total_symbols);
+        auto depuncturer = depuncturer_t(
+            punctured_symbols+symbol_offset, total_symbols-symbol_offset,
+            puncture_code, puncture_code_length,
+            unpunctured_symbol_value);
+        depuncturer.index_puncture_code = hypothesis.puncture_phase;
+        depuncturers.push_back(depuncturer);
+
+        results[i].index = i;
+        results[i].is_complete = true;
+    }
+
+    auto decode_hypotheses = [&](const size_t thread_index) {
+        soft_t symbols[BLOCK_SIZE];
+        std::vector<size_t> total_hypothesis_symbols(total_hypotheses, 0u);
+        for (size_t offset = 0u; offset < total_output_symbols; offset += BLOCK_SIZE) {
+            const size_t total_block_symbols = min(total_output_symbols-offset, BLOCK_SIZE);
+            for (size_t i = thread_index; i < total_hypotheses; i += total_threads) {
+                auto& res = results[i];
+                if (!res.is_complete) continue;
+                const size_t total_read = depuncturers[i].read(symbols, total_block_symbols);
+                res.error += decoders[i]->template push_symbols<decoder_t, uint64_t>(symbols, total_read);
+                total_hypothesis_symbols[i] += total_read;
+                res.is_complete = (total_read == total_block_symbols);
+            }
+        }
+        for (size_t i = thread_index; i < total_hypotheses; i += total_threads) {
+            auto& res = results[i];
+            res.total_decoded_bits = total_hypothesis_symbols[i] / R;
+            res.total_erasures = total_hypothesis_symbols[i] - depuncturers[i].index_punctured_symbol;
+            res.error += uint64_t(decoders[i]->get_reliability().best_error);
+            assert(res.error >= res.total_erasures*erasure_error);
+            res.error -= res.total_erasures*erasure_error;
+        }
+    };
+
+    if (total_threads == 1u) {
+        decode_hypotheses(0u);
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(total_threads);
+        for (size_t i = 0u; i < total_threads; i++) {
+            workers.emplace_back(decode_hypotheses, i);
+        }
+        for (auto& worker: workers) {
+            worker.join();
+        }
+    }
+
+    std::sort(results.begin(), results.end(), [](const auto& a, const auto& b) {
+        if (a.is_complete != b.is_complete) return a.is_complete;
+        if (a.error != b.error) return a.error < b.error;
+        return a.index < b.index;
+    });
+    return results;
+}
@@ -47,44 +47,51 @@ const std::vector<SIMD_Type> SIMD_Type_List = {
 
 // NOTE: Use these classes inside template parameters 
 //       so factory code is generated inside the function template
-class ViterbiDecoder_Factory_u16
+//       The observed factories pass an observer to each decoder, see viterbi/viterbi_decoder_observer.h
+template <typename observer_t = ViterbiDecoder_NullObserver>
+class ViterbiDecoder_ObservedFactory_u16
 {
 public:
     template <size_t K, size_t R>
-    using SCALAR = ViterbiDecoder_Scalar<K,R,uint16_t,int16_t>;
+    using SCALAR = ViterbiDecoder_Scalar<K,R,uint16_t,int16_t,observer_t>;
     #if defined(__SSE4_2__)
     template <size_t K, size_t R>
-    using SIMD_SSE = ViterbiDecoder_SSE_u16<K,R>;
+    using SIMD_SSE = ViterbiDecoder_SSE_u16<K,R,observer_t>;
     #endif
     #if defined(__AVX2__)
     template <size_t K, size_t R>
-    using SIMD_AVX = ViterbiDecoder_AVX_u16<K,R>;
+    using SIMD_AVX = ViterbiDecoder_AVX_u16<K,R,observer_t>;
     #endif
     #if defined(__SIMD_NEON__)
     template <size_t K, size_t R>
-    using SIMD_NEON = ViterbiDecoder_NEON_u16<K,R>;
+    using SIMD_NEON = ViterbiDecoder_NEON_u16<K,R,observer_t>;
     #endif
 };
 
-class ViterbiDecoder_Factory_u8
+using ViterbiDecoder_Factory_u16 = ViterbiDecoder_ObservedFactory_u16<>;
+
+template <typename observer_t = ViterbiDecoder_NullObserver>
+class ViterbiDecoder_ObservedFactory_u8
 {
 public:
     template <size_t K, size_t R>
-    using SCALAR = ViterbiDecoder_Scalar<K,R,uint8_t,int8_t>;
+    using SCALAR = ViterbiDecoder_Scalar<K,R,uint8_t,int8_t,observer_t>;
     #if defined(__SSE4_2__)
     template <size_t K, size_t R>
-    using SIMD_SSE = ViterbiDecoder_SSE_u8<K,R>;
+    using SIMD_SSE = ViterbiDecoder_SSE_u8<K,R,observer_t>;
     #endif
     #if defined(__AVX2__)
     template <size_t K, size_t R>
-    using SIMD_AVX = ViterbiDecoder_AVX_u8<K,R>;
+    using SIMD_AVX = ViterbiDecoder_AVX_u8<K,R,observer_t>;
     #endif
     #if defined(__SIMD_NEON__)
     template <size_t K, size_t R>
-    using SIMD_NEON = ViterbiDecoder_NEON_u8<K,R>;
+    using SIMD_NEON = ViterbiDecoder_NEON_u8<K,R,observer_t>;
     #endif
 };
 
+using ViterbiDecoder_Factory_u8 = ViterbiDecoder_ObservedFactory_u8<>;
+
 #if defined(__SSE4_2__)
 #define __SELECT_FACTORY_ITEM_SSE(FACTORY, INDEX, K, R, BLOCK) case SIMD_Type::SIMD_SSE: { using it = typename FACTORY::template SIMD_SSE<K,R>; BLOCK }; break;
 #else
@@ -1,12 +1,15 @@
 #pragma once
 
 #include "viterbi/convolutional_encoder.h"
+#include "viterbi/convolutional_encoder_templated.h"
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 #include <vector>
 #include <random>
 #include "utility/basic_ops.h"
 #include "utility/bitcount_table.h"
+#include "utility/xoshiro256.h"
 
 void generate_random_bytes(uint8_t* data, const size_t N) {
     for (size_t i = 0u; i < N; i++) {
@@ -63,25 +66,71 @@ size_t encode_data(
     return total_output_symbols;
 }
 
+template <size_t K, size_t R, typename T>
+size_t encode_data(
+    ConvolutionalEncoderT<K,R>& enc, 
+    const uint8_t* input_bytes, const size_t total_input_bytes,
+    T* output_symbols, [[maybe_unused]] const size_t max_output_symbols,
+    const T soft_decision_high,
+    const T soft_decision_low) 
+{
+    const size_t total_input_bits = total_input_bytes*8;
+    const size_t total_tail_bits = K-1;
+    const size_t total_output_symbols = (total_input_bits + total_tail_bits) * R;
+    assert(total_output_symbols <= max_output_symbols);
+
+    size_t curr_output_symbol = 0u;
+    curr_output_symbol += enc.encode_block(
+        input_bytes, total_input_bytes, &output_symbols[curr_output_symbol], 
+        soft_decision_high, soft_decision_low);
+    // terminate tail at state 0
+    curr_output_symbol += enc.encode_tail(
+        &output_symbols[curr_output_symbol], 
+        soft_decision_high, soft_decision_low);
+
+    assert(curr_output_symbol == total_output_symbols);
+    return total_output_symbols;
+}
+
+// Shared generator for the noise helpers so each thread gets a reproducible stream
+Xoshiro256_Lanes& get_noise_rng() {
+    static thread_local Xoshiro256_Lanes rng;
+    return rng;
+}
+
+/// @brief Call func(i, x) for each index with a uniform random 32bit value
+template <typename F>
+void for_each_random_word(const size_t N, F&& func) {
+    constexpr size_t BLOCK_SIZE = 2u*Xoshiro256_Lanes::TOTAL_LANES;
+    auto& rng = get_noise_rng();
+    uint64_t block[Xoshiro256_Lanes::TOTAL_LANES];
+    uint32_t words[BLOCK_SIZE];
+    for (size_t i = 0u; i < N; i += BLOCK_SIZE) {
+        rng.generate(block);
+        memcpy(words, block, sizeof(block));
+        const size_t M = ((N-i) < BLOCK_SIZE) ? (N-i) : BLOCK_SIZE;
+        for (size_t j = 0u; j < M; j++) {
+            func(i+j, words[j]);
+        }
+    }
+}
+
 template <typename T>
 void add_noise(T* data, const size_t N, const uint64_t noise_level) {
-    const uint64_t noise_threshold = noise_level+1;
-    for (size_t i = 0u; i < N; i++) {
-        auto& v = data[i];
-        const T n = T(std::rand() % noise_threshold);
-        v += n;
-    }
+    const uint32_t noise_threshold = uint32_t(noise_level+1);
+    for_each_random_word(N, [&](const size_t i, const uint32_t x) {
+        data[i] += T(get_random_below(x, noise_threshold));
+    });
 }
 
 template <typename T>
 void add_binary_noise(T* data, const size_t N, const uint64_t noise_level, const uint64_t max_noise) {
-    const uint64_t mod_noise = max_noise*2u;
-    for (size_t i = 0u; i < N; i++) {
-        const uint64_t noise_value = uint64_t(std::rand()) % mod_noise;
-        if (noise_value <= noise_level)  {
+    const uint32_t mod_noise = uint32_t(max_noise*2u);
+    for_each_random_word(N, [&](const size_t i, const uint32_t x) {
+        if (uint64_t(get_random_below(x, mod_noise)) <= noise_level) {
             data[i] = -data[i];
         }
-    }
+    });
 }
 
 template <typename T>
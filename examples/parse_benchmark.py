@@ -1,6 +1,7 @@
 import argparse
 import json
 import math
+import sys
 from enum import Enum
 # dependencies
 import numpy as np
@@ -28,6 +29,20 @@ def get_simd_type(x: str) -> SimdType:
             return type
     raise Exception(f"invalid simd type '{x}'")
 
+class TimingStats:
+    def __init__(self, mean_ns: float, std_ns: float, total_samples: int):
+        self.mean_ns = mean_ns
+        self.std_ns = std_ns
+        self.total_samples = total_samples
+
+    @staticmethod
+    def from_array(x):
+        return TimingStats(float(np.mean(x)), float(np.std(x, ddof=1)) if len(x) > 1 else 0.0, len(x))
+
+    @staticmethod
+    def from_summary(data, total_samples):
+        return TimingStats(data["mean_ns"], data["stddev_ns"], total_samples)
+
 class Sample:
     def __init__(self, data):
         self.name = data["name"]
@@ -38,10 +53,134 @@ class Sample:
         self.G = data["G"]
         self.total_input_bits = data["total_input_bits"]
         self.total_symbols = data["total_symbols"]
-        self.update_symbols_ns = np.array(data["update_symbols_ns"])
-        self.chainback_bit_ns = np.array(data["chainback_bits_ns"])
-        self.symbol_rate = self.total_symbols / (self.update_symbols_ns*1e-9)
-        self.chainback_rate = self.total_input_bits / (self.chainback_bit_ns*1e-9)
+        # symbols are noiseless unless run with -E or -I
+        self.input = data.get("input", "noiseless")
+        self.EbNo_dB = data.get("EbNo_dB", None)
+        if "update_symbols_ns" in data:
+            # raw timings from older files or when run with -r
+            update_symbols_ns = np.array(data["update_symbols_ns"])
+            chainback_bits_ns = np.array(data["chainback_bits_ns"])
+            symbol_rate = self.total_symbols / (update_symbols_ns*1e-9)
+            chainback_rate = self.total_input_bits / (chainback_bits_ns*1e-9)
+            self.total_samples = len(update_symbols_ns)
+            self.update_time = TimingStats.from_array(update_symbols_ns)
+            self.chainback_time = TimingStats.from_array(chainback_bits_ns)
+            self.mean_symbol_rate = np.mean(symbol_rate)
+            self.std_symbol_rate = np.std(symbol_rate)
+            self.mean_chainback_rate = np.mean(chainback_rate)
+            self.std_chainback_rate = np.std(chainback_rate)
+        else:
+            # summary statistics of timings, spread of rate is estimated from relative spread of time
+            update, chainback = data["update"], data["chainback"]
+            self.total_samples = data["total_samples"]
+            self.update_time = TimingStats.from_summary(update, self.total_samples)
+            self.chainback_time = TimingStats.from_summary(chainback, self.total_samples)
+            self.mean_symbol_rate = self.total_symbols / (update["mean_ns"]*1e-9)
+            self.std_symbol_rate = self.mean_symbol_rate * update["stddev_ns"] / update["mean_ns"]
+            self.mean_chainback_rate = self.total_input_bits / (chainback["mean_ns"]*1e-9)
+            self.std_chainback_rate = self.mean_chainback_rate * chainback["stddev_ns"] / chainback["mean_ns"]
+        # hardware counters per decoded bit when run with -H
+        self.update_perf = data.get("update", {}).get("perf", None)
+        self.chainback_perf = data.get("chainback", {}).get("perf", None)
+
+    def get_key(self):
+        return (self.name, self.decode_type, self.simd_type)
+
+    def get_workload(self):
+        # timings are only comparable if the decoder was given the same symbols
+        return (self.input, self.EbNo_dB, self.total_input_bits)
+
+def betacf(a: float, b: float, x: float) -> float:
+    # continued fraction for the incomplete beta function, Numerical Recipes 6.4
+    MAX_ITERATIONS, EPSILON, FPMIN = 300, 3e-16, 1e-300
+    qab, qap, qam = a+b, a+1.0, a-1.0
+    c, d = 1.0, 1.0 - qab*x/qap
+    d = 1.0/(d if abs(d) > FPMIN else FPMIN)
+    h = d
+    for m in range(1, MAX_ITERATIONS+1):
+        m2 = 2*m
+        aa = m*(b-m)*x/((qam+m2)*(a+m2))
+        d = 1.0 + aa*d
+        d = 1.0/(d if abs(d) > FPMIN else FPMIN)
+        c = 1.0 + aa/c
+        c = c if abs(c) > FPMIN else FPMIN
+        h *= d*c
+        aa = -(a+m)*(qab+m)*x/((a+m2)*(qap+m2))
+        d = 1.0 + aa*d
+        d = 1.0/(d if abs(d) > FPMIN else FPMIN)
+        c = 1.0 + aa/c
+        c = c if abs(c) > FPMIN else FPMIN
+        delta = d*c
+        h *= delta
+        if abs(delta-1.0) < EPSILON:
+            break
+    return h
+
+def incomplete_beta(a: float, b: float, x: float) -> float:
+    if x <= 0.0: return 0.0
+    if x >= 1.0: return 1.0
+    log_front = math.lgamma(a+b) - math.lgamma(a) - math.lgamma(b) + a*math.log(x) + b*math.log(1.0-x)
+    front = math.exp(log_front)
+    if x < (a+1.0)/(a+b+2.0):
+        return front*betacf(a, b, x)/a
+    return 1.0 - front*betacf(b, a, 1.0-x)/b
+
+def welch_t_test(x0: TimingStats, x1: TimingStats) -> (float, float, float):
+    # returns t statistic, degrees of freedom and two sided p-value
+    if x0.total_samples < 2 or x1.total_samples < 2:
+        return (0.0, 0.0, 1.0)
+    v0 = x0.std_ns**2 / x0.total_samples
+    v1 = x1.std_ns**2 / x1.total_samples
+    if v0 + v1 <= 0.0:
+        return (0.0, 0.0, 0.0 if x0.mean_ns != x1.mean_ns else 1.0)
+    t = (x1.mean_ns - x0.mean_ns) / math.sqrt(v0 + v1)
+    df = (v0 + v1)**2 / (v0**2/(x0.total_samples-1) + v1**2/(x1.total_samples-1))
+    p = incomplete_beta(df/2.0, 0.5, df/(df + t*t))
+    return (t, df, p)
+
+def load_samples(filename: str):
+    with open(filename, "r") as fp:
+        json_text = fp.read()
+    json_data = json.loads(json_text)
+    return [Sample(x) for x in json_data]
+
+def compare_to_baseline(baseline_samples, samples, threshold: float, alpha: float) -> int:
+    baseline_lookup = {s.get_key(): s for s in baseline_samples}
+    total_regressions = 0
+    total_missing = 0
+    total_mismatched = 0
+    print(f" {'Name':>16} | {'Decode':>6} | {'SIMD':>9} | {'Stage':>9} | {'Base ns':>10} | {'New ns':>10} | {'Speedup':>7} | {'p-value':>8} | Status")
+    for s in samples:
+        base = baseline_lookup.get(s.get_key(), None)
+        if base is None:
+            total_missing += 1
+            continue
+        if base.get_workload() != s.get_workload():
+            print(f" {s.name:>16} | {s.decode_type.name:>6} | {s.simd_type.name.lower():>9} | baseline has input={base.input},EbNo_dB={base.EbNo_dB},bits={base.total_input_bits} "
+                  f"but got input={s.input},EbNo_dB={s.EbNo_dB},bits={s.total_input_bits}")
+            total_mismatched += 1
+            continue
+        for stage, x0, x1 in (("update", base.update_time, s.update_time), ("chainback", base.chainback_time, s.chainback_time)):
+            _, _, p = welch_t_test(x0, x1)
+            speedup = x0.mean_ns / x1.mean_ns if x1.mean_ns > 0 else math.inf
+            change = x1.mean_ns / x0.mean_ns - 1.0 if x0.mean_ns > 0 else 0.0
+            is_significant = p < alpha
+            if is_significant and change > threshold:
+                status = "REGRESSION"
+                total_regressions += 1
+            elif is_significant and change < -threshold:
+                status = "improved"
+            elif is_significant:
+                status = "within threshold"
+            else:
+                status = "no change"
+            print(f" {s.name:>16} | {s.decode_type.name:>6} | {s.simd_type.name.lower():>9} | {stage:>9} | {x0.mean_ns:10.1f} | {x1.mean_ns:10.1f} | {speedup:6.3f}x | {p:8.2e} | {status}")
+    if total_missing > 0:
+        print(f"{total_missing} cases are missing from the baseline")
+    if total_mismatched > 0:
+        print(f"{total_mismatched} cases were not compared since their input differs from the baseline")
+    print(f"{total_regressions} regressions over {threshold*100:.1f}% with p < {alpha}")
+    return 1 if (total_regressions > 0 or total_mismatched > 0) else 0
 
 SCALE_SUFFIXES = [(1e12,"tera"),(1e9,"giga"),(1e6,"mega"),(1e3,"kilo"),(1e0,""),(1e-3,"milli"),(1e-6,"micro"),(1e-9,"nano")]
 def get_scale_suffix(x: float) -> (float, str):
@@ -61,13 +200,13 @@ def main():
     parser.add_argument("--filter-decode", help="Filter for specific decoder type", choices=[e.name.lower() for e in DecodeType], default=[], nargs='+')
     parser.add_argument("--filter-simd", help="Filter for specific simd type", choices=[e.name.lower() for e in SimdType], default=[], nargs='+')
     parser.add_argument("--list-codes", help="List all codes in file", action='store_true')
+    parser.add_argument("--baseline", help="Compare against baseline output from run_benchmark.cpp", default=None)
+    parser.add_argument("--threshold", help="Percentage slowdown in mean time that counts as a regression", type=float, default=5.0)
+    parser.add_argument("--alpha", help="Significance level of the Welch t-test", type=float, default=0.01)
     args = parser.parse_args()
  
     # parse
-    with open(args.filename, "r") as fp:
-        json_text = fp.read()
-    json_data = json.loads(json_text)
-    all_samples = [Sample(x) for x in json_data]
+    all_samples = load_samples(args.filename)
 
     if args.list_codes:
         samples = {s.name:s for s in all_samples}.values()
@@ -90,6 +229,10 @@ def main():
         return True
     all_samples = list(filter(filter_samples, all_samples))
 
+    if args.baseline is not None:
+        baseline_samples = load_samples(args.baseline)
+        return compare_to_baseline(baseline_samples, all_samples, args.threshold*1e-2, args.alpha)
+
     # print in groups of name->decode_type->simd_type
     sorted_keys = set(((s.name, s.K, s.R) for s in all_samples))
     sorted_keys = list(sorted(sorted_keys, key=lambda s: (2**s[1]-1)*s[2]))
@@ -112,12 +255,17 @@ def main():
             scalar_mean_symbol_rate = None
             scalar_mean_chainback_rate = None
             s = samples[0]
-            print(f"name='{s.name}',K={s.K},R={s.R},decode={s.decode_type.name}")
+            str_input = ""
+            if s.input == "awgn":
+                str_input = f",input=awgn,EbNo_dB={s.EbNo_dB:.2f}"
+            elif s.input != "noiseless":
+                str_input = f",input={s.input}"
+            print(f"name='{s.name}',K={s.K},R={s.R},decode={s.decode_type.name}{str_input}")
             for s in samples:
-                mean_symbol_rate = np.mean(s.symbol_rate)
-                mean_chainback_rate = np.mean(s.chainback_rate)
-                std_symbol_rate = np.std(s.symbol_rate)
-                std_chainback_rate = np.std(s.chainback_rate)
+                mean_symbol_rate = s.mean_symbol_rate
+                mean_chainback_rate = s.mean_chainback_rate
+                std_symbol_rate = s.std_symbol_rate
+                std_chainback_rate = s.std_chainback_rate
                 if not scalar_mean_symbol_rate is None:
                     ratio_update = mean_symbol_rate/scalar_mean_symbol_rate
                     ratio_chainback = mean_chainback_rate/scalar_mean_chainback_rate
@@ -132,13 +280,18 @@ def main():
                 scale, prefix = get_scale_suffix(mean_chainback_rate) 
                 str_chainback = f"{mean_chainback_rate/scale:.2f} ± {std_chainback_rate/scale:.2f} {prefix}"
 
-                print(f"simd={s.simd_type.name.lower()},samples={len(s.update_symbols_ns)}")
+                print(f"simd={s.simd_type.name.lower()},samples={s.total_samples}")
                 print(f" update    = {str_update}symbols/s {postfix_update}")
                 print(f" chainback = {str_chainback}bits/s {postfix_chainback}")
+                for label, perf in ((" update   ", s.update_perf), (" chainback", s.chainback_perf)):
+                    if perf is None:
+                        continue
+                    fields = [f"{k}={v:.3f}" for k, v in perf.items() if v is not None]
+                    print(f"{label} : {', '.join(fields)}")
                 if s.simd_type == SimdType.SCALAR:
                     scalar_mean_symbol_rate = mean_symbol_rate
                     scalar_mean_chainback_rate = mean_chainback_rate
             print()
 
 if __name__ == '__main__':
-    main()
+    sys.exit(main())
@@ -29,7 +29,7 @@ def get_simd_type(x: str) -> SimdType:
     raise Exception(f"invalid simd type '{x}'")
 
 class Sample:
-    def __init__(self, data):
+    def __init__(self, data, key="ber"):
         self.name = data["name"]
         self.decode_type = get_decode_type(data["decode_type"])
         self.simd_type = get_simd_type(data["simd_type"])
@@ -38,12 +38,42 @@ class Sample:
         self.G = data["G"]
         self.EbNo_dB = []
         self.ber = []
+        self.ber_lower = []
+        self.ber_upper = []
+        # older results don't have confidence intervals
+        rates = data[key]
+        lower = data.get(f"{key}_lower", rates)
+        upper = data.get(f"{key}_upper", rates)
         # filter for log y-axis
-        for (x,y) in zip(data["EbNo_dB"], data["ber"]):
+        for (x,y,y_lower,y_upper) in zip(data["EbNo_dB"], rates, lower, upper):
             if y == 0.0:
                 continue
             self.EbNo_dB.append(x)
             self.ber.append(y)
+            self.ber_lower.append(y_lower)
+            self.ber_upper.append(y_upper)
+
+def load_sweeps(json_text: str):
+    # older results are a single json list with one entry per sweep
+    if json_text.lstrip().startswith("["):
+        return json.loads(json_text)
+    # newer results are json lines with one entry per point
+    sweeps = {}
+    for line in json_text.splitlines():
+        line = line.strip()
+        if not line:
+            continue
+        point = json.loads(line)
+        key = (point["name"], point["decode_type"], point["simd_type"])
+        sweeps.setdefault(key, []).append(point)
+    all_data = []
+    for points in sweeps.values():
+        points = sorted(points, key=lambda p: p["point_index"])
+        data = {k:points[0][k] for k in ["name", "decode_type", "simd_type", "K", "R", "G"]}
+        for k in ["EbNo_dB", "ber", "ber_lower", "ber_upper", "fer", "fer_lower", "fer_upper"]:
+            data[k] = [p[k] for p in points]
+        all_data.append(data)
+    return all_data
 
 def main():
     parser = argparse.ArgumentParser(
@@ -56,13 +86,15 @@ def main():
     parser.add_argument("--filter-decode", help="Filter for specific decoder type", choices=[e.name.lower() for e in DecodeType], default=[], nargs='+')
     parser.add_argument("--filter-simd", help="Filter for specific simd type", choices=[e.name.lower() for e in SimdType], default=[], nargs='+')
     parser.add_argument("--list-codes", help="List all codes in file", action='store_true')
+    parser.add_argument("--fer", help="Plot frame error rate instead of bit error rate", action='store_true')
     args = parser.parse_args()
  
     # parse
     with open(args.filename, "r") as fp:
         json_text = fp.read()
-    json_data = json.loads(json_text)
-    all_samples = [Sample(x) for x in json_data]
+    json_data = load_sweeps(json_text)
+    key = "fer" if args.fer else "ber"
+    all_samples = [Sample(x, key) for x in json_data]
 
     if args.list_codes:
         samples = {s.name:s for s in all_samples}.values()
@@ -127,12 +159,13 @@ def main():
             for s in samples:
                 line_colour = decode_type_colours[s.decode_type]
                 ax.semilogy(s.EbNo_dB, s.ber, label=s.decode_type.name.lower(), marker=".", color=line_colour)
+                ax.fill_between(s.EbNo_dB, s.ber_lower, s.ber_upper, color=line_colour, alpha=0.2, linewidth=0)
             ax.set_title(f"{s.simd_type.name}", fontsize=9)
             ax.grid(True, which="both")
             ax.legend(loc="lower left") # BER is highest for lower Eb/No values
             ax.set_xticks(xticks, minor=True)
             ax.set_yticks(yticks, minor=True)
-            ax.set_ylabel("Bit error rate")
+            ax.set_ylabel("Frame error rate" if args.fer else "Bit error rate")
             if row_id == total_rows-1:
                 ax.set_xlabel("Eb/No (dB)")
             else:
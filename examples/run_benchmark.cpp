@@ -7,9 +7,10 @@
 #include <inttypes.h>
 #include <cctype>
 #include <vector>
-#include <random>
 #include <optional>
 #include <mutex>
+#include <atomic>
+#include <thread>
 
 #include "viterbi/convolutional_encoder.h"
 #include "viterbi/convolutional_encoder_lookup.h"
@@ -20,20 +21,42 @@
 #include "helpers/simd_type.h"
 #include "helpers/decode_type.h"
 #include "helpers/test_helpers.h"
+#include "helpers/channel_model.h"
 #include "helpers/cli_filters.h"
 #include "getopt/getopt.h"
 #include "utility/timer.h"
 #include "utility/span.h"
 #include "utility/thread_pool.h"
+#include "utility/statistics.h"
+#include "utility/cpu_affinity.h"
+#include "utility/perf_counters.h"
+#include "utility/cache_info.h"
 
 struct TestResult {
     uint64_t update_symbols_ns;
     uint64_t chainback_bits_ns;
 };
 
+struct BenchmarkStatistics {
+    SampleStatistics update_symbols_ns;
+    SampleStatistics chainback_bits_ns;
+    SampleStatistics total_ns;
+    PerfCounts update_perf;
+    PerfCounts chainback_perf;
+};
+
 struct Arguments {
     float total_duration_seconds;
+    float warmup_duration_seconds;
     size_t total_input_bytes;
+    bool is_pin_threads;
+    bool is_summary;
+    bool is_raw_samples;
+    bool is_perf_counters;
+    size_t max_scaling_workers;
+    size_t max_sweep_input_bytes;
+    std::optional<float> EbNo_dB;
+    bool is_replay_capture;
     CLI_Filters filters;
 };
 
@@ -53,16 +76,58 @@ void run_test(
     ViterbiDecoder_Core<K,R,error_t,soft_t>& vitdec, 
     const soft_t* symbols, const size_t total_symbols, 
     const uint8_t* in_bytes, uint8_t* out_bytes, const size_t total_input_bytes,
-    const float total_duration_seconds,
-    std::vector<TestResult>& out_results
+    const float total_duration_seconds, const float warmup_duration_seconds,
+    BenchmarkStatistics& out_stats, std::vector<TestResult>* out_raw_results,
+    PerfCounters* perf_counters
+);
+
+const char* get_input_source_str(const Arguments& args);
+
+template <size_t K, size_t R, typename code_t, typename soft_t>
+void generate_symbols(
+    const Code<K,R,code_t>& code, const soft_t soft_decision_high, const soft_t soft_decision_low,
+    const Arguments& args, std::vector<uint8_t>& tx_input_bytes, std::vector<soft_t>& symbols
 );
 
 template <size_t K, size_t R, typename code_t>
 void fprintf_results(
     FILE* fp_out, 
     const Code<K,R,code_t>& code, DecodeType decode_type, SIMD_Type simd_type,
-    tcb::span<const TestResult> results,
-    size_t total_input_bytes, size_t total_symbols
+    const BenchmarkStatistics& stats, const std::vector<TestResult>* raw_results,
+    size_t total_input_bytes, size_t total_symbols,
+    const Arguments& args, std::optional<size_t> total_bit_errors
+);
+
+void fprintf_summary_header(FILE* fp_out, const Arguments& args);
+void fprintf_scaling_header(FILE* fp_out, const Arguments& args);
+
+template <size_t K, size_t R, typename code_t>
+void select_scaling_code(const Code<K,R,code_t>& code, size_t code_id, const Arguments& args);
+
+void fprintf_sweep_header(FILE* fp_out, const Arguments& args, const CacheInfo& cache_info);
+
+template <size_t K, size_t R, typename code_t>
+void select_sweep_code(const Code<K,R,code_t>& code, size_t code_id, const Arguments& args, const CacheInfo& cache_info);
+
+template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void init_sweep_test(
+    const Code<K,R,code_t>& code, 
+    Decoder_Config<soft_t,error_t>(*config_factory)(const size_t),
+    DecodeType decode_type, const Arguments& args, const CacheInfo& cache_info
+);
+
+template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void init_scaling_test(
+    const Code<K,R,code_t>& code, 
+    Decoder_Config<soft_t,error_t>(*config_factory)(const size_t),
+    DecodeType decode_type, const Arguments& args
+);
+
+template <size_t K, size_t R, typename code_t>
+void fprintf_summary(
+    FILE* fp_out, 
+    const Code<K,R,code_t>& code, DecodeType decode_type, SIMD_Type simd_type,
+    const BenchmarkStatistics& stats, size_t total_input_bytes, size_t total_symbols
 );
 
 
@@ -72,6 +137,16 @@ void usage() {
         "    [-t <total_threads> (default: 1)]\n"
         "    [-T <total_duration_of_benchmark_seconds> (default: 1.0)]\n"
         "    [-M <total_input_bytes> (default: 256)]\n"
+        "    [-w <warmup_duration_seconds> (default: 0.1)]\n"
+        "    [-p Pin each worker thread to a cpu]\n"
+        "    [-q Print compact summary table instead of json]\n"
+        "    [-r Include raw per iteration timings in json]\n"
+        "    [-H Measure hardware performance counters (linux only)]\n"
+        "    [-o <output_filename> (default: stdout)]\n"
+        "    [-S <max_workers> Measure throughput scaling of 1 to N pinned workers on the same decoder]\n"
+        "    [-F <max_input_bytes> Sweep frame length from 32 bytes to N bytes against the cache sizes]\n"
+        "    [-E <EbNo_dB> Pass symbols through an AWGN channel (default: noiseless)]\n"
+        "    [-I <captured_symbols_filename> Replay signed 8bit symbols from a capture]\n"
     );
     cli_filters_print_usage();
     fprintf(stderr,
@@ -84,15 +159,32 @@ static std::unique_ptr<ThreadPool> thread_pool = nullptr;
 static std::mutex mutex_stderr;
 static std::mutex mutex_fp_out;
 static FILE* fp_out = stdout;
-static std::vector<std::vector<TestResult>> g_per_thread_test_results;
+static std::vector<std::vector<TestResult>> g_per_thread_raw_results;
+static std::vector<int8_t> g_captured_symbols;
+// Noise is generated from a fixed seed so that every decoder and run sees the same channel
+static constexpr unsigned int AWGN_RANDOM_SEED = 0u;
+// Frame lengths of the sweep double from the minimum up to the maximum
+static constexpr size_t SWEEP_MIN_INPUT_BYTES = 32u;
+// Longer frames are skipped once the decisions no longer fit in a reasonable amount of memory
+static constexpr size_t SWEEP_MAX_DECISION_BYTES = size_t(1u) << 30;
 
 int main(int argc, char** argv) {
     int total_threads = 1;
     float total_duration_seconds = 1.0;
+    float warmup_duration_seconds = 0.1f;
     int total_input_bytes = 256;
+    bool is_pin_threads = false;
+    bool is_summary = false;
+    bool is_raw_samples = false;
+    bool is_perf_counters = false;
+    const char* output_filename = nullptr;
+    int max_scaling_workers = 0;
+    int max_sweep_input_bytes = 0;
+    std::optional<float> EbNo_dB = std::nullopt;
+    const char* captured_symbols_filename = nullptr;
     CLI_Filters filters;
     while (true) {
-        const int opt = getopt_custom(argc, argv, "t:T:h" CLI_FILTERS_GETOPT_STRING);
+        const int opt = getopt_custom(argc, argv, "t:T:M:w:pqrHo:S:F:E:I:h" CLI_FILTERS_GETOPT_STRING);
         if (opt == -1) break;
         switch (opt) {
             case 't':
@@ -104,6 +196,44 @@ int main(int argc, char** argv) {
             case 'M':
                 total_input_bytes = atoi(optarg);
                 break;
+            case 'w':
+                warmup_duration_seconds = float(atof(optarg));
+                break;
+            case 'p':
+                is_pin_threads = true;
+                break;
+            case 'q':
+                is_summary = true;
+                break;
+            case 'r':
+                is_raw_samples = true;
+                break;
+            case 'H':
+                is_perf_counters = true;
+                break;
+            case 'o':
+                output_filename = optarg;
+                break;
+            case 'S':
+                max_scaling_workers = atoi(optarg);
+                if (max_scaling_workers <= 0) {
+                    fprintf(stderr, "Maximum number of scaling workers must be > 0, got %d\n", max_scaling_workers);
+                    return 1;
+                }
+                break;
+            case 'F':
+                max_sweep_input_bytes = atoi(optarg);
+                if (max_sweep_input_bytes < int(SWEEP_MIN_INPUT_BYTES)) {
+                    fprintf(stderr, "Maximum input bytes of sweep must be >= %zu, got %d\n", SWEEP_MIN_INPUT_BYTES, max_sweep_input_bytes);
+                    return 1;
+                }
+                break;
+            case 'E':
+                EbNo_dB = std::optional(float(atof(optarg)));
+                break;
+            case 'I':
+                captured_symbols_filename = optarg;
+                break;
             case 'h':
                 usage();
                 return 0;
@@ -131,22 +261,114 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    if (warmup_duration_seconds < 0.0f) {
+        fprintf(stderr, "Duration of warmup in seconds must be non-negative (%.3f)\n", warmup_duration_seconds);
+        return 1;
+    }
+
     if (total_input_bytes <= 0) {
         fprintf(stderr, "Total input bytes must be > 0, got %d\n", total_input_bytes);
         return 1;
     }
 
+    if (is_summary && is_raw_samples) {
+        fprintf(stderr, "Raw samples are only available in json output\n");
+        return 1;
+    }
+
+    if (EbNo_dB.has_value() && (captured_symbols_filename != nullptr)) {
+        fprintf(stderr, "AWGN channel and replay of captured symbols cannot be used together\n");
+        return 1;
+    }
+
+    if (captured_symbols_filename != nullptr) {
+        if (!load_captured_symbols(captured_symbols_filename, g_captured_symbols)) {
+            fprintf(stderr, "Failed to open captured symbols file '%s'\n", captured_symbols_filename);
+            return 1;
+        }
+        if (g_captured_symbols.empty()) {
+            fprintf(stderr, "Captured symbols file '%s' is empty\n", captured_symbols_filename);
+            return 1;
+        }
+        fprintf(stderr, "Loaded %zu captured symbols from '%s'\n", g_captured_symbols.size(), captured_symbols_filename);
+    }
+
     Arguments args;
     args.total_duration_seconds = total_duration_seconds;
+    args.warmup_duration_seconds = warmup_duration_seconds;
     args.total_input_bytes = size_t(total_input_bytes);
+    args.is_pin_threads = is_pin_threads;
+    args.is_summary = is_summary;
+    args.is_raw_samples = is_raw_samples;
+    args.is_perf_counters = is_perf_counters;
+    args.max_scaling_workers = size_t(max_scaling_workers);
+    args.max_sweep_input_bytes = size_t(max_sweep_input_bytes);
+    args.EbNo_dB = EbNo_dB;
+    args.is_replay_capture = captured_symbols_filename != nullptr;
     args.filters = filters;
 
+    if (output_filename != nullptr) {
+        fp_out = fopen(output_filename, "w");
+        if (fp_out == nullptr) {
+            fprintf(stderr, "Failed to open output file '%s'\n", output_filename);
+            return 1;
+        }
+    }
+
+    if ((args.max_scaling_workers > 0) && (args.max_sweep_input_bytes > 0)) {
+        fprintf(stderr, "Scaling mode and frame length sweep cannot be used together\n");
+        return 1;
+    }
+
+    // Sweep mode runs each decoder over increasing frame lengths one at a time
+    if (args.max_sweep_input_bytes > 0) {
+        const auto cache_info = get_cache_info();
+        if (args.is_pin_threads && !pin_current_thread_to_cpu(0)) {
+            fprintf(stderr, "Failed to pin sweep to cpu=0\n");
+        }
+        fprintf_sweep_header(fp_out, args, cache_info);
+        size_t code_id = 0;
+        FOR_COMMON_CODES({
+            const auto& code = it;
+            select_sweep_code(code, code_id, args, cache_info);
+            code_id++;
+        });
+        if (fp_out != stdout) {
+            fclose(fp_out);
+        }
+        return 0;
+    }
+
+    // Scaling mode runs each decoder on an increasing number of workers one at a time
+    if (args.max_scaling_workers > 0) {
+        fprintf_scaling_header(fp_out, args);
+        size_t code_id = 0;
+        FOR_COMMON_CODES({
+            const auto& code = it;
+            select_scaling_code(code, code_id, args);
+            code_id++;
+        });
+        if (fp_out != stdout) {
+            fclose(fp_out);
+        }
+        return 0;
+    }
+
     thread_pool = std::make_unique<ThreadPool>(size_t(total_threads));
-    g_per_thread_test_results.resize(thread_pool->get_total_threads());
-    for (auto& pool: g_per_thread_test_results) {
-        pool.reserve(4096);
+    if (is_raw_samples) {
+        g_per_thread_raw_results.resize(thread_pool->get_total_threads());
+        for (auto& pool: g_per_thread_raw_results) {
+            pool.reserve(4096);
+        }
     }
  
+    // Results are printed by worker threads as soon as tasks are pushed
+    if (args.is_summary) {
+        fprintf_summary_header(fp_out, args);
+    } else {
+        fprintf(fp_out, "[\n");
+    }
+
     size_t code_id = 0;
     FOR_COMMON_CODES({
         const auto& code = it;
@@ -157,11 +379,13 @@ int main(int argc, char** argv) {
     const int total_tasks = thread_pool->get_total_tasks();
     fprintf(stderr, "Using %zu threads\n", thread_pool->get_total_threads());
     fprintf(stderr, "Total tasks in thread pool: %d\n", total_tasks);
-    if (total_tasks > 0) {
-        fprintf(fp_out, "[\n");
-        thread_pool->wait_all();
+    thread_pool->wait_all();
+    if (!args.is_summary) {
         fprintf(fp_out, "]\n");
     }
+    if (fp_out != stdout) {
+        fclose(fp_out);
+    }
     return 0;
 }
 
@@ -191,8 +415,13 @@ void init_test(
             using decoder_t = it;
             if constexpr(decoder_t::is_valid) {
                 thread_pool->push_task([code, config, decode_type, simd_type, args](size_t thread_id) {
-                    const float total_duration_seconds = args.total_duration_seconds;
-                    auto enc = ConvolutionalEncoder_ShiftRegister(code.K, code.R, code.G.data());
+                    if (args.is_pin_threads) {
+                        const size_t cpu_index = thread_id % get_total_cpus();
+                        if (!pin_current_thread_to_cpu(cpu_index)) {
+                            auto lock_stderr = std::scoped_lock(mutex_stderr);
+                            fprintf(stderr, "Failed to pin thread=%zu to cpu=%zu\n", thread_id, cpu_index);
+                        }
+                    }
                     auto branch_table = ViterbiBranchTable<K,R,soft_t>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
                     auto vitdec = ViterbiDecoder_Core<K,R,error_t,soft_t>(branch_table, config.decoder_config);
                     // Generate test data
@@ -212,51 +441,129 @@ void init_test(
                     }
  
                     std::srand(static_cast<unsigned int>(time(NULL)));
-                    generate_random_bytes(tx_input_bytes.data(), tx_input_bytes.size());
-                    encode_data(
-                        &enc, 
-                        tx_input_bytes.data(), tx_input_bytes.size(), 
-                        output_symbols.data(), output_symbols.size(),
-                        config.soft_decision_high, config.soft_decision_low
-                    );
+                    generate_symbols(code, config.soft_decision_high, config.soft_decision_low, args, tx_input_bytes, output_symbols);
  
-                    auto& results = g_per_thread_test_results[thread_id];
-                    results.clear();
+                    std::vector<TestResult>* raw_results = nullptr;
+                    if (args.is_raw_samples) {
+                        raw_results = &g_per_thread_raw_results[thread_id];
+                        raw_results->clear();
+                    }
+                    auto stats = std::make_unique<BenchmarkStatistics>();
+                    // Counters only measure the thread which opened them
+                    std::unique_ptr<PerfCounters> perf_counters = nullptr;
+                    if (args.is_perf_counters) {
+                        perf_counters = std::make_unique<PerfCounters>();
+                        if (!perf_counters->is_available()) {
+                            auto lock_stderr = std::scoped_lock(mutex_stderr);
+                            fprintf(stderr, "Hardware performance counters are unavailable on thread=%zu\n", thread_id);
+                        }
+                    }
 
                     vitdec.set_traceback_length(total_input_bits);
                     run_test<decoder_t>(
                         vitdec, 
                         output_symbols.data(), output_symbols.size(), 
                         tx_input_bytes.data(), rx_input_bytes.data(), total_input_bytes,
-                        total_duration_seconds,
-                        results
+                        args.total_duration_seconds, args.warmup_duration_seconds,
+                        *stats, raw_results, perf_counters.get()
                     );
-                    const size_t total_results = results.size();
+                    const size_t total_results = stats->total_ns.get_total_samples();
+                    // The transmitted data is unknown for captured symbols
+                    std::optional<size_t> total_bit_errors = std::nullopt;
+                    if (!args.is_replay_capture) {
+                        total_bit_errors = get_total_bit_errors(tx_input_bytes.data(), rx_input_bytes.data(), total_input_bytes);
+                    }
                     auto lock_stderr = std::scoped_lock(mutex_stderr);
-                    fprintf(stderr, "thread=%zu,name='%s',K=%zu,R=%zu,decode=%s,simd=%s,input_bytes=%zu,total_results=%zu\n", 
+                    fprintf(stderr, "thread=%zu,name='%s',K=%zu,R=%zu,decode=%s,simd=%s,input=%s,input_bytes=%zu,total_results=%zu\n", 
                         thread_id,
                         code.name, code.K, code.R, 
                         get_decode_type_str(decode_type), get_simd_type_string(simd_type), 
-                        total_input_bytes, total_results
+                        get_input_source_str(args), total_input_bytes, total_results
                     );
                     auto lock_fp_out = std::scoped_lock(mutex_fp_out);
-                    fprintf_results(fp_out, code, decode_type, simd_type, results, total_input_bytes, output_symbols.size());
+                    if (args.is_summary) {
+                        fprintf_summary(fp_out, code, decode_type, simd_type, *stats, total_input_bytes, output_symbols.size());
+                    } else {
+                        fprintf_results(
+                            fp_out, code, decode_type, simd_type, *stats, raw_results, total_input_bytes, output_symbols.size(),
+                            args, total_bit_errors
+                        );
+                    }
                 });
             }
         });
     }
 }
 
+const char* get_input_source_str(const Arguments& args) {
+    if (args.is_replay_capture) return "capture";
+    if (args.EbNo_dB.has_value()) return "awgn";
+    return "noiseless";
+}
+
+// Noiseless symbols sit at the soft decision extremes which understates the work done by the decoder
+// An AWGN channel or a capture gives realistic renormalisation frequency and decision patterns
+template <size_t K, size_t R, typename code_t, typename soft_t>
+void generate_symbols(
+    const Code<K,R,code_t>& code, const soft_t soft_decision_high, const soft_t soft_decision_low,
+    const Arguments& args, std::vector<uint8_t>& tx_input_bytes, std::vector<soft_t>& symbols
+) {
+    if (args.is_replay_capture) {
+        replay_captured_symbols(g_captured_symbols, symbols.data(), symbols.size(), soft_decision_high, soft_decision_low);
+        return;
+    }
+
+    auto enc = ConvolutionalEncoder_ShiftRegister(code.K, code.R, code.G.data());
+    if (!args.EbNo_dB.has_value()) {
+        generate_random_bytes(tx_input_bytes.data(), tx_input_bytes.size());
+        encode_data(
+            &enc, 
+            tx_input_bytes.data(), tx_input_bytes.size(), 
+            symbols.data(), symbols.size(),
+            soft_decision_high, soft_decision_low
+        );
+        return;
+    }
+
+    auto noise_gen = NormalGenerator(AWGN_RANDOM_SEED);
+    noise_gen.get_rng().fill_bytes(tx_input_bytes.data(), tx_input_bytes.size());
+    std::vector<float> tx_symbols;
+    tx_symbols.resize(symbols.size());
+    encode_data(
+        &enc, 
+        tx_input_bytes.data(), tx_input_bytes.size(), 
+        tx_symbols.data(), tx_symbols.size(),
+        1.0f, -1.0f
+    );
+    const auto channel = AWGN_Channel<soft_t>(args.EbNo_dB.value(), R, soft_decision_high, soft_decision_low);
+    channel.transmit(tx_symbols.data(), symbols.data(), symbols.size(), noise_gen);
+}
+
 template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
 void run_test(
     ViterbiDecoder_Core<K,R,error_t,soft_t>& vitdec, 
     const soft_t* symbols, const size_t total_symbols, 
     const uint8_t* in_bytes, uint8_t* out_bytes, const size_t total_input_bytes,
-    const float total_duration_seconds,
-    std::vector<TestResult>& out_results
+    const float total_duration_seconds, const float warmup_duration_seconds,
+    BenchmarkStatistics& out_stats, std::vector<TestResult>* out_raw_results,
+    PerfCounters* perf_counters
 ) {
     const size_t total_input_bits = total_input_bytes*8u;
 
+    // Warm up caches, branch predictors and cpu frequency before measuring
+    {
+        Timer warmup_time;
+        while (true) {
+            const float seconds_elapsed = float(warmup_time.get_delta<std::chrono::milliseconds>())*1e-3f;
+            if (seconds_elapsed >= warmup_duration_seconds) {
+                break;
+            }
+            vitdec.reset();
+            decoder_t::template update<uint64_t>(vitdec, symbols, total_symbols);
+            vitdec.chainback(out_bytes, total_input_bits, 0u);
+        }
+    }
+
     Timer total_time;
     size_t curr_iteration = 0;
     while (true) {
@@ -269,17 +576,26 @@ void run_test(
             Timer t;
             vitdec.reset();
         }
+        if (perf_counters != nullptr) perf_counters->start();
         {
             Timer t;
             const uint64_t accumulated_error = decoder_t::template update<uint64_t>(vitdec, symbols, total_symbols);
             result.update_symbols_ns = t.get_delta();
         }
+        if (perf_counters != nullptr) perf_counters->stop(out_stats.update_perf);
+        if (perf_counters != nullptr) perf_counters->start();
         {
             Timer t;
             vitdec.chainback(out_bytes, total_input_bits, 0u);
             result.chainback_bits_ns = t.get_delta();
         }
-        out_results.push_back(result);
+        if (perf_counters != nullptr) perf_counters->stop(out_stats.chainback_perf);
+        out_stats.update_symbols_ns.push(result.update_symbols_ns);
+        out_stats.chainback_bits_ns.push(result.chainback_bits_ns);
+        out_stats.total_ns.push(result.update_symbols_ns + result.chainback_bits_ns);
+        if (out_raw_results != nullptr) {
+            out_raw_results->push_back(result);
+        }
     }
 }
 
@@ -289,18 +605,120 @@ void fprintf_list(FILE* fp_out, const char* formatter, tcb::span<const T> list,
     const size_t N = list.size();
     for (size_t i = 0; i < N; i++) {
         fprintf(fp_out, formatter, func(list[i]));
-        if (i < (N-1)) printf(",");
+        if (i < (N-1)) fprintf(fp_out, ",");
     }
     fprintf(fp_out, "]");
 }
 
+// Throughput is derived from the mean time since means are additive across iterations
+// The confidence interval of the mean time is mapped onto the throughput using its relative width
+struct Throughput {
+    double mbits_per_second;
+    double mbits_per_second_ci95;
+    double ns_per_bit;
+};
+
+static Throughput get_throughput(const SampleStatistics& stats, const size_t total_bits) {
+    Throughput res;
+    const double mean_ns = stats.get_mean();
+    res.mbits_per_second = (mean_ns > 0.0) ? (double(total_bits) / mean_ns * 1e3) : 0.0;
+    res.mbits_per_second_ci95 = (mean_ns > 0.0) ? (res.mbits_per_second * stats.get_ci95() / mean_ns) : 0.0;
+    res.ns_per_bit = mean_ns / double(total_bits);
+    return res;
+}
+
+// Each decoded bit including the tail updates every state in the trellis
+template <size_t K, size_t R>
+static double get_ns_per_state_update(const SampleStatistics& stats, const size_t total_symbols) {
+    constexpr size_t total_states = size_t(1u) << (K-1u);
+    const size_t total_decoded_bits = total_symbols / R;
+    return stats.get_mean() / double(total_decoded_bits * total_states);
+}
+
+void fprintf_statistics(FILE* fp_out, const SampleStatistics& stats, const size_t total_bits) {
+    const auto throughput = get_throughput(stats, total_bits);
+    fprintf(fp_out, "\"mean_ns\": %.1f, ", stats.get_mean());
+    fprintf(fp_out, "\"stddev_ns\": %.1f, ", stats.get_stddev());
+    fprintf(fp_out, "\"ci95_ns\": %.1f, ", stats.get_ci95());
+    fprintf(fp_out, "\"min_ns\": %.1f, ", stats.get_min());
+    fprintf(fp_out, "\"median_ns\": %.1f, ", stats.get_median());
+    fprintf(fp_out, "\"p99_ns\": %.1f, ", stats.get_percentile(0.99));
+    fprintf(fp_out, "\"p999_ns\": %.1f, ", stats.get_percentile(0.999));
+    fprintf(fp_out, "\"max_ns\": %.1f, ", stats.get_max());
+    fprintf(fp_out, "\"mbits_per_second\": %.3f, ", throughput.mbits_per_second);
+    fprintf(fp_out, "\"mbits_per_second_ci95\": %.3f, ", throughput.mbits_per_second_ci95);
+    fprintf(fp_out, "\"ns_per_bit\": %.4f", throughput.ns_per_bit);
+}
+
+// Hardware counters normalised to each decoded bit across all iterations
+struct PerfMetrics {
+    bool is_valid[TOTAL_PERF_EVENTS];
+    double per_bit[TOTAL_PERF_EVENTS];
+    bool is_ipc_valid;
+    double ipc;
+};
+
+static bool get_perf_metrics(const PerfCounts& counts, const size_t total_bits, PerfMetrics& metrics) {
+    bool is_any_valid = false;
+    for (size_t i = 0u; i < TOTAL_PERF_EVENTS; i++) {
+        metrics.is_valid[i] = counts.is_valid[i] && (total_bits > 0u);
+        metrics.per_bit[i] = metrics.is_valid[i] ? (double(counts.values[i]) / double(total_bits)) : 0.0;
+        is_any_valid = is_any_valid || metrics.is_valid[i];
+    }
+    const uint64_t total_cycles = counts.get(PerfEvent::CYCLES);
+    metrics.is_ipc_valid = counts.has(PerfEvent::CYCLES) && counts.has(PerfEvent::INSTRUCTIONS) && (total_cycles > 0u);
+    metrics.ipc = metrics.is_ipc_valid ? (double(counts.get(PerfEvent::INSTRUCTIONS)) / double(total_cycles)) : 0.0;
+    return is_any_valid;
+}
+
+void fprintf_perf_metrics(FILE* fp_out, const PerfCounts& counts, const size_t total_bits) {
+    PerfMetrics metrics;
+    if (!get_perf_metrics(counts, total_bits, metrics)) return;
+    fprintf(fp_out, ", \"perf\": { ");
+    for (const auto event: Perf_Event_List) {
+        const size_t i = size_t(event);
+        if (metrics.is_valid[i]) {
+            fprintf(fp_out, "\"%s_per_bit\": %.4f, ", get_perf_event_str(event), metrics.per_bit[i]);
+        } else {
+            fprintf(fp_out, "\"%s_per_bit\": null, ", get_perf_event_str(event));
+        }
+    }
+    if (metrics.is_ipc_valid) {
+        fprintf(fp_out, "\"ipc\": %.3f }", metrics.ipc);
+    } else {
+        fprintf(fp_out, "\"ipc\": null }");
+    }
+}
+
+void fprintf_perf_summary(FILE* fp_out, const char* label, const PerfCounts& counts, const size_t total_bits) {
+    PerfMetrics metrics;
+    if (!get_perf_metrics(counts, total_bits, metrics)) return;
+    fprintf(fp_out, "%*s |", 18, label);
+    for (const auto event: Perf_Event_List) {
+        const size_t i = size_t(event);
+        if (metrics.is_valid[i]) {
+            fprintf(fp_out, " %s/bit=%.3f", get_perf_event_str(event), metrics.per_bit[i]);
+        } else {
+            fprintf(fp_out, " %s/bit=n/a", get_perf_event_str(event));
+        }
+    }
+    if (metrics.is_ipc_valid) {
+        fprintf(fp_out, " ipc=%.2f\n", metrics.ipc);
+    } else {
+        fprintf(fp_out, " ipc=n/a\n");
+    }
+}
+
 template <size_t K, size_t R, typename code_t>
 void fprintf_results(
     FILE* fp_out, 
     const Code<K,R,code_t>& code, DecodeType decode_type, SIMD_Type simd_type,
-    tcb::span<const TestResult> results,
-    size_t total_input_bytes, size_t total_symbols
+    const BenchmarkStatistics& stats, const std::vector<TestResult>* raw_results,
+    size_t total_input_bytes, size_t total_symbols,
+    const Arguments& args, std::optional<size_t> total_bit_errors
 ) {
+    const size_t total_measured_bits = total_input_bytes*8u*stats.total_ns.get_total_samples();
+    const size_t total_input_bits = total_input_bytes*8u;
     if (!g_is_first_result) {
         fprintf(fp_out, ",\n");
     } else {
@@ -315,13 +733,369 @@ void fprintf_results(
     fprintf(fp_out, " \"G\": ");
     fprintf_list(fp_out, "%u", tcb::span<const code_t>(code.G), [](const auto& e) { return e; });
     fprintf(fp_out, ",\n");
-    fprintf(fp_out, " \"total_input_bits\": %zu,\n", total_input_bytes*8);
+    fprintf(fp_out, " \"total_input_bits\": %zu,\n", total_input_bits);
     fprintf(fp_out, " \"total_symbols\": %zu,\n", total_symbols);
-    fprintf(fp_out, " \"update_symbols_ns\": ");
-    fprintf_list(fp_out, "%" PRIu64, tcb::span<const TestResult>(results), [](const auto& e) { return e.update_symbols_ns; });
-    fprintf(fp_out, ",\n");
-    fprintf(fp_out, " \"chainback_bits_ns\": ");
-    fprintf_list(fp_out, "%" PRIu64, tcb::span<const TestResult>(results), [](const auto& e) { return e.chainback_bits_ns; });
+    fprintf(fp_out, " \"input\": \"%s\",\n", get_input_source_str(args));
+    if (args.EbNo_dB.has_value()) {
+        fprintf(fp_out, " \"EbNo_dB\": %.2f,\n", args.EbNo_dB.value());
+    } else {
+        fprintf(fp_out, " \"EbNo_dB\": null,\n");
+    }
+    if (total_bit_errors.has_value()) {
+        fprintf(fp_out, " \"bit_errors\": %zu,\n", total_bit_errors.value());
+    } else {
+        fprintf(fp_out, " \"bit_errors\": null,\n");
+    }
+    fprintf(fp_out, " \"total_samples\": %zu,\n", stats.total_ns.get_total_samples());
+    fprintf(fp_out, " \"ns_per_state_update\": %.4f,\n", get_ns_per_state_update<K,R>(stats.update_symbols_ns, total_symbols));
+    fprintf(fp_out, " \"update\": { ");
+    fprintf_statistics(fp_out, stats.update_symbols_ns, total_input_bits);
+    fprintf_perf_metrics(fp_out, stats.update_perf, total_measured_bits);
+    fprintf(fp_out, " },\n");
+    fprintf(fp_out, " \"chainback\": { ");
+    fprintf_statistics(fp_out, stats.chainback_bits_ns, total_input_bits);
+    fprintf_perf_metrics(fp_out, stats.chainback_perf, total_measured_bits);
+    fprintf(fp_out, " },\n");
+    fprintf(fp_out, " \"total\": { ");
+    fprintf_statistics(fp_out, stats.total_ns, total_input_bits);
+    fprintf(fp_out, " }");
+    if (raw_results != nullptr) {
+        fprintf(fp_out, ",\n");
+        fprintf(fp_out, " \"update_symbols_ns\": ");
+        fprintf_list(fp_out, "%" PRIu64, tcb::span<const TestResult>(*raw_results), [](const auto& e) { return e.update_symbols_ns; });
+        fprintf(fp_out, ",\n");
+        fprintf(fp_out, " \"chainback_bits_ns\": ");
+        fprintf_list(fp_out, "%" PRIu64, tcb::span<const TestResult>(*raw_results), [](const auto& e) { return e.chainback_bits_ns; });
+    }
     fprintf(fp_out, "\n");
     fprintf(fp_out, "}");
-}
\ No newline at end of file
+}
+
+// Tables only mention the input when it isn't the default noiseless symbols
+void fprintf_input_header(FILE* fp_out, const Arguments& args) {
+    if (args.EbNo_dB.has_value()) {
+        fprintf(fp_out, "input=%s EbNo_dB=%.2f\n", get_input_source_str(args), args.EbNo_dB.value());
+    } else if (args.is_replay_capture) {
+        fprintf(fp_out, "input=%s\n", get_input_source_str(args));
+    }
+}
+
+void fprintf_summary_header(FILE* fp_out, const Arguments& args) {
+    fprintf_input_header(fp_out, args);
+    fprintf(fp_out,
+        "%*s | %*s | %*s |  K  R | %*s | %*s | %*s | %*s | %*s | %*s | %*s | %*s\n",
+        16, "Name", 6, "Decode", 8, "SIMD",
+        8, "Mbit/s", 6, "CI95",
+        7, "ns/bit", 8, "ns/state",
+        9, "p50 us", 9, "p99 us", 9, "p99.9 us",
+        7, "samples"
+    );
+}
+
+template <size_t K, size_t R, typename code_t>
+void fprintf_summary(
+    FILE* fp_out, 
+    const Code<K,R,code_t>& code, DecodeType decode_type, SIMD_Type simd_type,
+    const BenchmarkStatistics& stats, size_t total_input_bytes, size_t total_symbols
+) {
+    const auto& total = stats.total_ns;
+    const auto throughput = get_throughput(total, total_input_bytes*8u);
+    const double ns_per_state_update = get_ns_per_state_update<K,R>(stats.update_symbols_ns, total_symbols);
+    fprintf(fp_out,
+        "%*s | %*s | %*s | %2zu %2zu | %*.2f | %*.2f | %*.3f | %*.4f | %*.2f | %*.2f | %*.2f | %*zu\n",
+        16, code.name, 6, get_decode_type_str(decode_type), 8, get_simd_type_string(simd_type),
+        code.K, code.R,
+        8, throughput.mbits_per_second, 6, throughput.mbits_per_second_ci95,
+        7, throughput.ns_per_bit, 8, ns_per_state_update,
+        9, total.get_median()*1e-3, 9, total.get_percentile(0.99)*1e-3, 9, total.get_percentile(0.999)*1e-3,
+        7, total.get_total_samples()
+    );
+    const size_t total_measured_bits = total_input_bytes*8u*total.get_total_samples();
+    fprintf_perf_summary(fp_out, "update", stats.update_perf, total_measured_bits);
+    fprintf_perf_summary(fp_out, "chainback", stats.chainback_perf, total_measured_bits);
+}
+
+struct ScalingResult {
+    size_t total_workers;
+    double mbits_per_second;
+    double gbytes_per_second;
+};
+
+// Each worker has a private decoder and copy of the symbols while the branch table is shared
+// All workers are released together after their warmup and stopped together after the benchmark duration
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+ScalingResult run_scaling_workers(
+    const ViterbiBranchTable<K,R,soft_t>& branch_table, const ViterbiDecoder_Config<error_t>& config,
+    const std::vector<soft_t>& symbols, const size_t total_input_bytes, const size_t bytes_per_iteration,
+    const size_t total_workers, const Arguments& args
+) {
+    using Core = ViterbiDecoder_Core<K,R,error_t,soft_t>;
+    struct alignas(64) WorkerResult {
+        uint64_t total_iterations = 0;
+        uint64_t total_ns = 0;
+    };
+    std::vector<WorkerResult> results;
+    results.resize(total_workers);
+    std::atomic<size_t> total_ready{0};
+    std::atomic<bool> is_start{false};
+    std::atomic<bool> is_stop{false};
+    const size_t total_input_bits = total_input_bytes*8u;
+    const size_t total_cpus = get_total_cpus();
+
+    std::vector<std::thread> workers;
+    workers.reserve(total_workers);
+    for (size_t i = 0u; i < total_workers; i++) {
+        workers.emplace_back([&, i]() {
+            if (!pin_current_thread_to_cpu(i % total_cpus)) {
+                auto lock_stderr = std::scoped_lock(mutex_stderr);
+                fprintf(stderr, "Failed to pin worker=%zu to cpu=%zu\n", i, i % total_cpus);
+            }
+            auto vitdec = std::make_unique<Core>(branch_table, config);
+            vitdec->set_traceback_length(total_input_bits);
+            const std::vector<soft_t> worker_symbols = symbols;
+            std::vector<uint8_t> out_bytes;
+            out_bytes.resize(total_input_bytes);
+
+            auto decode = [&]() {
+                vitdec->reset();
+                decoder_t::template update<uint64_t>(*vitdec, worker_symbols.data(), worker_symbols.size());
+                vitdec->chainback(out_bytes.data(), total_input_bits, 0u);
+            };
+
+            Timer warmup_time;
+            while (float(warmup_time.get_delta<std::chrono::milliseconds>())*1e-3f < args.warmup_duration_seconds) {
+                decode();
+            }
+
+            total_ready++;
+            while (!is_start.load()) {
+                std::this_thread::yield();
+            }
+
+            Timer total_time;
+            uint64_t total_iterations = 0u;
+            while (!is_stop.load(std::memory_order_relaxed)) {
+                decode();
+                total_iterations++;
+            }
+            results[i].total_ns = total_time.get_delta();
+            results[i].total_iterations = total_iterations;
+        });
+    }
+
+    while (total_ready.load() < total_workers) {
+        std::this_thread::yield();
+    }
+    is_start = true;
+    std::this_thread::sleep_for(std::chrono::duration<float>(args.total_duration_seconds));
+    is_stop = true;
+    for (auto& worker: workers) {
+        worker.join();
+    }
+
+    ScalingResult res;
+    res.total_workers = total_workers;
+    res.mbits_per_second = 0.0;
+    res.gbytes_per_second = 0.0;
+    for (const auto& worker: results) {
+        if (worker.total_ns == 0u) continue;
+        const double seconds = double(worker.total_ns)*1e-9;
+        res.mbits_per_second += double(worker.total_iterations*total_input_bits) / seconds * 1e-6;
+        res.gbytes_per_second += double(worker.total_iterations*bytes_per_iteration) / seconds * 1e-9;
+    }
+    return res;
+}
+
+template <size_t K, size_t R, typename code_t>
+void select_scaling_code(const Code<K,R,code_t>& code, size_t code_id, const Arguments& args) {
+    if (!args.filters.allow_code_index(code_id)) return;
+    for (const auto decode_type: Decode_Type_List) {
+        if (!args.filters.allow_decode_type(decode_type)) continue;
+        SELECT_DECODE_TYPE(decode_type, {
+            auto config = it0;
+            using factory_t = it1;
+            init_scaling_test<factory_t>(code, config, decode_type, args);
+        });
+    }
+}
+
+template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void init_scaling_test(
+    const Code<K,R,code_t>& code, 
+    Decoder_Config<soft_t,error_t>(*config_factory)(const size_t),
+    DecodeType decode_type, const Arguments& args
+) {
+    using Core = ViterbiDecoder_Core<K,R,error_t,soft_t>;
+    const Decoder_Config<soft_t, error_t> config = config_factory(code.R);
+    auto branch_table = std::make_unique<ViterbiBranchTable<K,R,soft_t>>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
+
+    const size_t total_input_bytes = args.total_input_bytes;
+    const size_t total_input_bits = total_input_bytes*8u;
+    const size_t total_decoded_bits = total_input_bits + (K-1u);
+    std::vector<uint8_t> tx_input_bytes;
+    std::vector<soft_t> symbols;
+    tx_input_bytes.resize(total_input_bytes);
+    symbols.resize(total_decoded_bits*R);
+    generate_symbols(code, config.soft_decision_high, config.soft_decision_low, args, tx_input_bytes, symbols);
+
+    // Estimate of the memory each worker touches on every decode
+    // Update streams the symbols in and the decisions out, then chainback reads one decision block per bit
+    const size_t decision_bytes = total_decoded_bits*Core::Decisions::SIZE_IN_BYTES;
+    const size_t symbol_bytes = symbols.size()*sizeof(soft_t);
+    const size_t chainback_bytes = total_input_bits*sizeof(typename Core::Decisions::format_t) + total_input_bytes;
+    const size_t bytes_per_iteration = decision_bytes + symbol_bytes + chainback_bytes;
+    const size_t working_set_bytes = decision_bytes + symbol_bytes + total_input_bytes + sizeof(typename Core::Metrics);
+
+    for (const auto simd_type: SIMD_Type_List) {
+        if (!args.filters.allow_simd_type(simd_type)) continue;
+        SELECT_FACTORY_ITEM(factory_t, simd_type, K, R, {
+            using decoder_t = it;
+            if constexpr(decoder_t::is_valid) {
+                std::vector<ScalingResult> results;
+                for (size_t total_workers = 1u; total_workers <= args.max_scaling_workers; total_workers++) {
+                    const auto res = run_scaling_workers<decoder_t>(
+                        *branch_table, config.decoder_config,
+                        symbols, total_input_bytes, bytes_per_iteration,
+                        total_workers, args
+                    );
+                    results.push_back(res);
+                    const double single_mbits_per_second = results[0].mbits_per_second;
+                    const double efficiency = res.mbits_per_second / (single_mbits_per_second * double(total_workers));
+                    fprintf(fp_out,
+                        "%*s | %*s | %*s | %2zu %2zu | %*zu | %*.2f | %*.2f | %*.3f | %*.3f | %*.1f\n",
+                        16, code.name, 6, get_decode_type_str(decode_type), 8, get_simd_type_string(simd_type),
+                        code.K, code.R,
+                        7, total_workers,
+                        9, res.mbits_per_second, 13, res.mbits_per_second / double(total_workers),
+                        10, efficiency, 9, res.gbytes_per_second,
+                        15, double(working_set_bytes*total_workers)/1024.0
+                    );
+                    fflush(fp_out);
+                }
+
+                // Throughput has saturated once another worker adds less than half of a single worker
+                size_t total_saturated_workers = 0u;
+                for (size_t i = 1u; i < results.size(); i++) {
+                    const double gain = results[i].mbits_per_second - results[i-1u].mbits_per_second;
+                    if (gain < 0.5*results[0].mbits_per_second) {
+                        total_saturated_workers = results[i-1u].total_workers;
+                        break;
+                    }
+                }
+                if (total_saturated_workers > 0u) {
+                    const auto& res = results[total_saturated_workers-1u];
+                    fprintf(fp_out, "%*s saturates after %zu workers at %.2f Mbit/s and %.3f GB/s\n",
+                        16, "", total_saturated_workers, res.mbits_per_second, res.gbytes_per_second);
+                } else {
+                    fprintf(fp_out, "%*s no saturation up to %zu workers\n", 16, "", args.max_scaling_workers);
+                }
+            }
+        });
+    }
+}
+
+void fprintf_scaling_header(FILE* fp_out, const Arguments& args) {
+    fprintf_input_header(fp_out, args);
+    fprintf(fp_out,
+        "%*s | %*s | %*s |  K  R | %*s | %*s | %*s | %*s | %*s | %*s\n",
+        16, "Name", 6, "Decode", 8, "SIMD",
+        7, "workers", 9, "Mbit/s", 13, "Mbit/s/worker",
+        10, "efficiency", 9, "est. GB/s", 15, "working set KiB"
+    );
+}
+
+template <size_t K, size_t R, typename code_t>
+void select_sweep_code(const Code<K,R,code_t>& code, size_t code_id, const Arguments& args, const CacheInfo& cache_info) {
+    if (!args.filters.allow_code_index(code_id)) return;
+    for (const auto decode_type: Decode_Type_List) {
+        if (!args.filters.allow_decode_type(decode_type)) continue;
+        SELECT_DECODE_TYPE(decode_type, {
+            auto config = it0;
+            using factory_t = it1;
+            init_sweep_test<factory_t>(code, config, decode_type, args, cache_info);
+        });
+    }
+}
+
+// The decision bits grow with the frame length while the metrics and branch table stay fixed
+// Throughput drops once the decisions written by update and read back by chainback spill out of a cache level
+template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void init_sweep_test(
+    const Code<K,R,code_t>& code, 
+    Decoder_Config<soft_t,error_t>(*config_factory)(const size_t),
+    DecodeType decode_type, const Arguments& args, const CacheInfo& cache_info
+) {
+    using Core = ViterbiDecoder_Core<K,R,error_t,soft_t>;
+    const Decoder_Config<soft_t, error_t> config = config_factory(code.R);
+    auto branch_table = std::make_unique<ViterbiBranchTable<K,R,soft_t>>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
+
+    for (const auto simd_type: SIMD_Type_List) {
+        if (!args.filters.allow_simd_type(simd_type)) continue;
+        SELECT_FACTORY_ITEM(factory_t, simd_type, K, R, {
+            using decoder_t = it;
+            if constexpr(decoder_t::is_valid) {
+                CacheLevel prev_cache_level = CacheLevel::L1D;
+                for (size_t total_input_bytes = SWEEP_MIN_INPUT_BYTES; total_input_bytes <= args.max_sweep_input_bytes; total_input_bytes *= 2u) {
+                    const size_t total_input_bits = total_input_bytes*8u;
+                    const size_t total_decoded_bits = total_input_bits + (K-1u);
+                    const size_t decision_bytes = total_decoded_bits*Core::Decisions::SIZE_IN_BYTES;
+                    if (decision_bytes > SWEEP_MAX_DECISION_BYTES) {
+                        fprintf(fp_out, "%*s skipping frames from %zu bytes since decisions exceed %zu MiB\n",
+                            16, "", total_input_bytes, SWEEP_MAX_DECISION_BYTES/(1024u*1024u));
+                        break;
+                    }
+
+                    std::vector<uint8_t> tx_input_bytes;
+                    std::vector<uint8_t> rx_input_bytes;
+                    std::vector<soft_t> symbols;
+                    tx_input_bytes.resize(total_input_bytes);
+                    rx_input_bytes.resize(total_input_bytes);
+                    symbols.resize(total_decoded_bits*R);
+                    generate_symbols(code, config.soft_decision_high, config.soft_decision_low, args, tx_input_bytes, symbols);
+
+                    auto vitdec = std::make_unique<Core>(*branch_table, config.decoder_config);
+                    vitdec->set_traceback_length(total_input_bits);
+                    auto stats = std::make_unique<BenchmarkStatistics>();
+                    run_test<decoder_t>(
+                        *vitdec, 
+                        symbols.data(), symbols.size(), 
+                        tx_input_bytes.data(), rx_input_bytes.data(), total_input_bytes,
+                        args.total_duration_seconds, args.warmup_duration_seconds,
+                        *stats, nullptr, nullptr
+                    );
+
+                    const auto update = get_throughput(stats->update_symbols_ns, total_input_bits);
+                    const auto chainback = get_throughput(stats->chainback_bits_ns, total_input_bits);
+                    const auto total = get_throughput(stats->total_ns, total_input_bits);
+                    const CacheLevel cache_level = get_cache_level(cache_info, decision_bytes);
+                    fprintf(fp_out,
+                        "%*s | %*s | %*s | %2zu %2zu | %*zu | %*.1f | %*s | %*.2f | %*.2f | %*.2f",
+                        16, code.name, 6, get_decode_type_str(decode_type), 8, get_simd_type_string(simd_type),
+                        code.K, code.R,
+                        11, total_input_bytes, 13, double(decision_bytes)/1024.0,
+                        7, get_cache_level_str(cache_level),
+                        13, update.mbits_per_second, 16, chainback.mbits_per_second, 12, total.mbits_per_second
+                    );
+                    if (cache_level != prev_cache_level) {
+                        fprintf(fp_out, " <- decisions exceed %s", get_cache_level_str(prev_cache_level));
+                    }
+                    fprintf(fp_out, "\n");
+                    fflush(fp_out);
+                    prev_cache_level = cache_level;
+                }
+            }
+        });
+    }
+}
+
+void fprintf_sweep_header(FILE* fp_out, const Arguments& args, const CacheInfo& cache_info) {
+    fprintf_input_header(fp_out, args);
+    fprintf(fp_out, "cache L1D=%zu KiB L2=%zu KiB LLC=%zu KiB\n",
+        cache_info.l1d_bytes/1024u, cache_info.l2_bytes/1024u, cache_info.llc_bytes/1024u);
+    fprintf(fp_out,
+        "%*s | %*s | %*s |  K  R | %*s | %*s | %*s | %*s | %*s | %*s\n",
+        16, "Name", 6, "Decode", 8, "SIMD",
+        11, "frame bytes", 13, "decisions KiB", 7, "fits in",
+        13, "update Mbit/s", 16, "chainback Mbit/s", 12, "total Mbit/s"
+    );
+}
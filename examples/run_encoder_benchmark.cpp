@@ -0,0 +1,357 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+#include <vector>
+#include <memory>
+
+#include "viterbi/convolutional_encoder.h"
+#include "viterbi/convolutional_encoder_lookup.h"
+#include "viterbi/convolutional_encoder_shift_register.h"
+#include "viterbi/convolutional_encoder_split_lookup.h"
+#include "viterbi/convolutional_encoder_bitsliced.h"
+#include "viterbi/convolutional_encoder_templated.h"
+#include "arch/simd_flags.h"
+#if defined(__PCLMUL__)
+#include "viterbi/x86/convolutional_encoder_pclmul.h"
+#endif
+#if defined(__SIMD_PMULL__)
+#include "viterbi/arm/convolutional_encoder_pmull.h"
+#endif
+
+#include "helpers/common_codes.h"
+#include "helpers/test_helpers.h"
+#include "helpers/cli_filters.h"
+#include "getopt/getopt.h"
+#include "utility/timer.h"
+
+struct Arguments {
+    float total_duration_seconds;
+    size_t total_input_bytes;
+    bool is_json;
+    CLI_Filters filters;
+};
+
+struct TestResult {
+    size_t total_iterations;
+    size_t total_input_bits;
+    uint64_t total_time_ns;
+    size_t total_table_bytes;
+    uint64_t construction_ns;
+};
+
+template <size_t K, size_t R, typename code_t>
+void run_encoders(const Code<K,R,code_t>& code, const Arguments& args);
+
+TestResult run_encoder(
+    ConvolutionalEncoder* enc,
+    const uint8_t* input_bytes, uint8_t* output_bytes, const size_t total_input_bytes,
+    const float total_duration_seconds
+);
+
+template <size_t total_lanes, size_t K, size_t R, typename code_t>
+TestResult run_bitsliced_encoder(
+    const Code<K,R,code_t>& code, const size_t total_input_bytes,
+    const float total_duration_seconds
+);
+
+template <size_t K, size_t R, typename code_t>
+TestResult run_templated_encoder(
+    const Code<K,R,code_t>& code, const uint8_t* input_bytes, const size_t total_input_bytes,
+    const float total_duration_seconds
+);
+
+void print_header(const Arguments& args);
+void print_footer(const Arguments& args);
+
+template <size_t K, size_t R, typename code_t>
+void print_result(const Code<K,R,code_t>& code, const char* encoder_name, const TestResult& result, const Arguments& args);
+
+void usage() {
+    fprintf(stderr,
+        " run_encoder_benchmark, Runs benchmark on convolutional encoders\n\n"
+        "    [-T <total_duration_of_benchmark_seconds> (default: 0.5)]\n"
+        "    [-M <total_input_bytes> (default: 4096)]\n"
+        "    [-j Print results as json instead of a table]\n"
+    );
+    cli_filters_print_usage(true, false);
+    fprintf(stderr,
+        "    [-h Show usage]\n"
+    );
+}
+
+int main(int argc, char** argv) {
+    float total_duration_seconds = 0.5f;
+    int total_input_bytes = 4096;
+    bool is_json = false;
+    CLI_Filters filters;
+    while (true) {
+        const int opt = getopt_custom(argc, argv, "T:M:jc:lh");
+        if (opt == -1) break;
+        switch (opt) {
+            case 'T':
+                total_duration_seconds = float(atof(optarg));
+                break;
+            case 'M':
+                total_input_bytes = atoi(optarg);
+                break;
+            case 'j':
+                is_json = true;
+                break;
+            case 'h':
+                usage();
+                return 0;
+            default: {
+                using R = CLI_Filters_Getopt_Result;
+                const auto res = cli_filters_parse_getopt(filters, opt, optarg, argv[0]);
+                if (res == R::ERROR_PARSE) return 1;
+                if (res == R::SUCCESS_EXIT) return 0;
+                if (res == R::NONE) {
+                    usage();
+                    return 1;
+                }
+                break;
+            }
+        }
+    }
+
+    if (total_duration_seconds <= 0.0f) {
+        fprintf(stderr, "Duration of benchmark in seconds must be positive (%.3f)\n", total_duration_seconds);
+        return 1;
+    }
+
+    if (total_input_bytes <= 0) {
+        fprintf(stderr, "Total input bytes must be > 0, got %d\n", total_input_bytes);
+        return 1;
+    }
+
+    Arguments args;
+    args.total_duration_seconds = total_duration_seconds;
+    args.total_input_bytes = size_t(total_input_bytes);
+    args.is_json = is_json;
+    args.filters = filters;
+
+    print_header(args);
+    size_t code_id = 0;
+    FOR_COMMON_CODES({
+        const auto& code = it;
+        if (args.filters.allow_code_index(code_id)) {
+            run_encoders(code, args);
+        }
+        code_id++;
+    });
+    print_footer(args);
+    return 0;
+}
+
+template <size_t K, size_t R, typename code_t>
+void run_encoders(const Code<K,R,code_t>& code, const Arguments& args) {
+    const size_t total_input_bytes = args.total_input_bytes;
+    std::vector<uint8_t> input_bytes;
+    std::vector<uint8_t> output_bytes;
+    input_bytes.resize(total_input_bytes);
+    output_bytes.resize(total_input_bytes*R);
+    generate_random_bytes(input_bytes.data(), input_bytes.size());
+
+    // Construction is timed since building the lookup table is significant for large K
+    auto run = [&](auto&& create_encoder, const char* name) {
+        Timer construction_time;
+        auto enc = create_encoder();
+        const uint64_t construction_ns = construction_time.get_delta();
+        auto result = run_encoder(
+            &enc, input_bytes.data(), output_bytes.data(), total_input_bytes,
+            args.total_duration_seconds);
+        result.total_table_bytes = enc.get_table_size();
+        result.construction_ns = construction_ns;
+        print_result(code, name, result, args);
+    };
+
+    run([&]() { return ConvolutionalEncoder_ShiftRegister<uint32_t>(code.K, code.R, code.G.data()); }, "Shift register");
+    run([&]() { return ConvolutionalEncoder_Lookup(code.K, code.R, code.G.data()); }, "Lookup");
+    run([&]() { return ConvolutionalEncoder_SplitLookup(code.K, code.R, code.G.data()); }, "Split lookup");
+    #if defined(__PCLMUL__)
+    run([&]() { return ConvolutionalEncoder_PCLMUL(code.K, code.R, code.G.data()); }, "PCLMUL");
+    #endif
+    #if defined(__SIMD_PMULL__)
+    run([&]() { return ConvolutionalEncoder_PMULL(code.K, code.R, code.G.data()); }, "PMULL");
+    #endif
+    // Writes R soft decision symbols per input bit instead of packed output bytes
+    {
+        const auto result = run_templated_encoder(code, input_bytes.data(), total_input_bytes, args.total_duration_seconds);
+        print_result(code, "Templated", result, args);
+    }
+    // Input is split evenly between frames
+    {
+        const auto result = run_bitsliced_encoder<1>(code, total_input_bytes, args.total_duration_seconds);
+        print_result(code, "Bitsliced x64", result, args);
+    }
+    {
+        const auto result = run_bitsliced_encoder<4>(code, total_input_bytes, args.total_duration_seconds);
+        print_result(code, "Bitsliced x256", result, args);
+    }
+}
+
+TestResult run_encoder(
+    ConvolutionalEncoder* enc,
+    const uint8_t* input_bytes, uint8_t* output_bytes, const size_t total_input_bytes,
+    const float total_duration_seconds
+) {
+    TestResult result;
+    result.total_iterations = 0;
+    result.total_input_bits = 0;
+    result.total_time_ns = 0;
+
+    const uint64_t total_duration_ns = uint64_t(double(total_duration_seconds) * 1e9);
+    Timer total_time;
+    while (true) {
+        enc->reset();
+        enc->consume_block(input_bytes, total_input_bytes, output_bytes);
+        result.total_iterations++;
+        result.total_input_bits += total_input_bytes*8u;
+        result.total_time_ns = total_time.get_delta();
+        if (result.total_time_ns > total_duration_ns) {
+            break;
+        }
+    }
+    return result;
+}
+
+template <size_t total_lanes, size_t K, size_t R, typename code_t>
+TestResult run_bitsliced_encoder(
+    const Code<K,R,code_t>& code, const size_t total_input_bytes,
+    const float total_duration_seconds
+) {
+    using encoder_t = ConvolutionalEncoder_BitSliced<K,R,total_lanes>;
+    constexpr size_t total_frames = encoder_t::TOTAL_FRAMES;
+    // Transposed layout has one word per lane for each input bit of all frames
+    const size_t total_frame_bits = max(total_input_bytes*8u / total_frames, size_t(1u));
+    std::vector<uint64_t> input_bits;
+    std::vector<uint64_t> output_bits;
+    input_bits.resize(total_frame_bits*total_lanes);
+    output_bits.resize(total_frame_bits*R*total_lanes);
+    generate_random_bytes(reinterpret_cast<uint8_t*>(input_bits.data()), input_bits.size()*sizeof(uint64_t));
+
+    Timer construction_time;
+    auto enc = encoder_t(code.G.data());
+    TestResult result;
+    result.construction_ns = construction_time.get_delta();
+    result.total_table_bytes = enc.get_table_size();
+    result.total_iterations = 0;
+    result.total_input_bits = 0;
+    result.total_time_ns = 0;
+
+    const uint64_t total_duration_ns = uint64_t(double(total_duration_seconds) * 1e9);
+    Timer total_time;
+    while (true) {
+        enc.reset();
+        enc.encode_transposed(input_bits.data(), total_frame_bits, output_bits.data());
+        result.total_iterations++;
+        result.total_input_bits += total_frame_bits*total_frames;
+        result.total_time_ns = total_time.get_delta();
+        if (result.total_time_ns > total_duration_ns) {
+            break;
+        }
+    }
+    return result;
+}
+
+template <size_t K, size_t R, typename code_t>
+TestResult run_templated_encoder(
+    const Code<K,R,code_t>& code, const uint8_t* input_bytes, const size_t total_input_bytes,
+    const float total_duration_seconds
+) {
+    using encoder_t = ConvolutionalEncoderT<K,R>;
+    std::vector<int8_t> output_symbols;
+    output_symbols.resize(total_input_bytes*8u*R);
+
+    Timer construction_time;
+    auto enc = encoder_t(code.G.data());
+    TestResult result;
+    result.construction_ns = construction_time.get_delta();
+    result.total_table_bytes = 0;
+    result.total_iterations = 0;
+    result.total_input_bits = 0;
+    result.total_time_ns = 0;
+
+    const uint64_t total_duration_ns = uint64_t(double(total_duration_seconds) * 1e9);
+    Timer total_time;
+    while (true) {
+        enc.reset();
+        enc.encode_block(input_bytes, total_input_bytes, output_symbols.data(), int8_t(+127), int8_t(-127));
+        result.total_iterations++;
+        result.total_input_bits += total_input_bytes*8u;
+        result.total_time_ns = total_time.get_delta();
+        if (result.total_time_ns > total_duration_ns) {
+            break;
+        }
+    }
+    return result;
+}
+
+static bool g_is_first_result = true;
+
+void print_header(const Arguments& args) {
+    if (args.is_json) {
+        printf("[\n");
+        return;
+    }
+    printf(
+        "%*s | %*s |  K  R | %*s | %*s | %*s | %*s\n",
+        14, "Encoder",
+        16, "Name",
+        10, "Mbit/s",
+        10, "MB/s",
+        12, "table KiB",
+        13, "construct us"
+    );
+}
+
+void print_footer(const Arguments& args) {
+    if (args.is_json) {
+        printf("\n]\n");
+    }
+}
+
+template <size_t K, size_t R, typename code_t>
+void print_result(const Code<K,R,code_t>& code, const char* encoder_name, const TestResult& result, const Arguments& args) {
+    const double total_bits = double(result.total_input_bits);
+    const double total_seconds = double(result.total_time_ns) * 1e-9;
+    const double mbits_per_second = total_bits / total_seconds * 1e-6;
+    const double mbytes_per_second = mbits_per_second / 8.0;
+    if (args.is_json) {
+        if (!g_is_first_result) {
+            printf(",\n");
+        } else {
+            g_is_first_result = false;
+        }
+        printf("{\n");
+        printf(" \"name\": \"%s\",\n", code.name);
+        printf(" \"encoder\": \"%s\",\n", encoder_name);
+        printf(" \"K\": %zu,\n", code.K);
+        printf(" \"R\": %zu,\n", code.R);
+        printf(" \"G\": [");
+        for (size_t i = 0; i < code.R; i++) {
+            printf("%u%s", unsigned(code.G[i]), (i < (code.R-1u)) ? "," : "");
+        }
+        printf("],\n");
+        printf(" \"total_input_bits\": %zu,\n", result.total_input_bits);
+        printf(" \"total_iterations\": %zu,\n", result.total_iterations);
+        printf(" \"mbits_per_second\": %.3f,\n", mbits_per_second);
+        printf(" \"mbytes_per_second\": %.3f,\n", mbytes_per_second);
+        printf(" \"table_bytes\": %zu,\n", result.total_table_bytes);
+        printf(" \"construction_ns\": %" PRIu64 "\n", result.construction_ns);
+        printf("}");
+        return;
+    }
+    printf(
+        "%*s | %*s | %2zu %2zu | %*.2f | %*.2f | %*.2f | %*.2f\n",
+        14, encoder_name,
+        16, code.name, code.K, code.R,
+        10, mbits_per_second,
+        10, mbytes_per_second,
+        12, double(result.total_table_bytes) / 1024.0,
+        13, double(result.construction_ns) * 1e-3
+    );
+}
@@ -0,0 +1,437 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+
+#include "viterbi/viterbi_decoder_core.h"
+#include "viterbi/viterbi_branch_table.h"
+
+#include "helpers/common_codes.h"
+#include "helpers/simd_type.h"
+#include "helpers/decode_type.h"
+#include "helpers/cli_filters.h"
+#include "getopt/getopt.h"
+#include "utility/timer.h"
+#include "utility/statistics.h"
+
+// Synthetic grid of codes which goes beyond the common codes
+constexpr size_t K_GRID_MIN = 3;
+constexpr size_t K_GRID_MAX = 16;
+constexpr size_t R_GRID_MIN = 2;
+constexpr size_t R_GRID_MAX = 7;
+
+// Branch metrics and decision packing are fused into each butterfly so they are timed as part of bfly
+enum class Kernel {
+    UPDATE, BFLY, RENORMALISE, CHAINBACK
+};
+
+const std::array<Kernel,4> Kernel_List = {
+    Kernel::UPDATE,
+    Kernel::BFLY,
+    Kernel::RENORMALISE,
+    Kernel::CHAINBACK,
+};
+
+constexpr
+const char* get_kernel_str(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::UPDATE:        return "update";
+    case Kernel::BFLY:          return "bfly";
+    case Kernel::RENORMALISE:   return "renormalise";
+    case Kernel::CHAINBACK:     return "chainback";
+    default:                    return "unknown";
+    }
+}
+
+// Calls the private kernels of each decoder
+template <class decoder_t>
+struct ViterbiDecoder_KernelAccess {
+    template <typename ... T>
+    static void bfly(T&& ... args) {
+        decoder_t::bfly(std::forward<T>(args)...);
+    }
+    template <typename error_t>
+    static error_t renormalise(error_t* metric) {
+        return decoder_t::renormalise(metric);
+    }
+};
+
+struct Arguments {
+    float cell_duration_seconds;
+    size_t total_steps;
+    bool is_csv;
+    bool is_normalise_states;
+    std::vector<size_t> K_values;
+    std::vector<size_t> R_values;
+    std::vector<Kernel> kernels;
+    CLI_Filters filters;
+
+    bool allow_K(size_t K) const { return K_values.empty() || (std::find(K_values.begin(), K_values.end(), K) != K_values.end()); }
+    bool allow_R(size_t R) const { return R_values.empty() || (std::find(R_values.begin(), R_values.end(), R) != R_values.end()); }
+    bool allow_kernel(Kernel k) const { return kernels.empty() || (std::find(kernels.begin(), kernels.end(), k) != kernels.end()); }
+};
+
+struct KernelResult {
+    Kernel kernel;
+    DecodeType decode_type;
+    const char* simd_name;
+    size_t K;
+    size_t R;
+    // Median time for one trellis step, one renormalisation or one decoded bit in chainback
+    double ns_per_step;
+};
+
+template <size_t K, size_t R>
+void run_code(const Arguments& args, std::vector<KernelResult>& results);
+
+template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void run_decode_type(
+    const Code<K,R,code_t>& code, const Arguments& args, DecodeType decode_type,
+    Decoder_Config<soft_t,error_t>(*config_factory)(const size_t),
+    std::vector<KernelResult>& results
+);
+
+void print_grids(const Arguments& args, const std::vector<KernelResult>& results);
+void print_csv(const std::vector<KernelResult>& results);
+
+void usage() {
+    fprintf(stderr,
+        " run_kernel_benchmark, Runs microbenchmarks on the components of each decoder\n\n"
+        "    [-T <duration_per_measurement_seconds> (default: 0.01)]\n"
+        "    [-M <total_trellis_steps> (default: 256)]\n"
+        "    [-K <constraint_length> (default: %zu..%zu)]\n"
+        "    [-R <code_rate> (default: %zu..%zu)]\n"
+        "    [-k <kernel> (default: None)]\n"
+        "        options: [",
+        K_GRID_MIN, K_GRID_MAX, R_GRID_MIN, R_GRID_MAX
+    );
+    bool is_first = true;
+    for (const auto kernel: Kernel_List) {
+        if (!is_first) fprintf(stderr, ",");
+        fprintf(stderr, "%s", get_kernel_str(kernel));
+        is_first = false;
+    }
+    fprintf(stderr, "]\n");
+    cli_filters_print_usage(false, true);
+    fprintf(stderr,
+        "    [-n Normalise grid values by the number of states]\n"
+        "    [-C Print results as csv]\n"
+        "    [-h Show usage]\n"
+    );
+}
+
+template <size_t K, size_t ... Rs>
+void run_rates(const Arguments& args, std::vector<KernelResult>& results, std::index_sequence<Rs...>) {
+    (run_code<K, Rs + R_GRID_MIN>(args, results), ...);
+}
+
+template <size_t ... Ks>
+void run_grid(const Arguments& args, std::vector<KernelResult>& results, std::index_sequence<Ks...>) {
+    (run_rates<Ks + K_GRID_MIN>(args, results, std::make_index_sequence<R_GRID_MAX-R_GRID_MIN+1>{}), ...);
+}
+
+int main(int argc, char** argv) {
+    Arguments args;
+    args.cell_duration_seconds = 0.01f;
+    args.is_csv = false;
+    args.is_normalise_states = false;
+    int total_steps = 256;
+    while (true) {
+        const int opt = getopt_custom(argc, argv, "T:M:K:R:k:nCd:s:h");
+        if (opt == -1) break;
+        switch (opt) {
+            case 'T':
+                args.cell_duration_seconds = float(atof(optarg));
+                break;
+            case 'M':
+                total_steps = atoi(optarg);
+                break;
+            case 'K': {
+                const int K = atoi(optarg);
+                if ((K < int(K_GRID_MIN)) || (K > int(K_GRID_MAX))) {
+                    fprintf(stderr, "Constraint length must be between %zu and %zu: %s\n", K_GRID_MIN, K_GRID_MAX, optarg);
+                    return 1;
+                }
+                args.K_values.push_back(size_t(K));
+                break;
+            }
+            case 'R': {
+                const int R = atoi(optarg);
+                if ((R < int(R_GRID_MIN)) || (R > int(R_GRID_MAX))) {
+                    fprintf(stderr, "Code rate must be between %zu and %zu: %s\n", R_GRID_MIN, R_GRID_MAX, optarg);
+                    return 1;
+                }
+                args.R_values.push_back(size_t(R));
+                break;
+            }
+            case 'k': {
+                bool is_found = false;
+                for (const auto kernel: Kernel_List) {
+                    if (strcmp(optarg, get_kernel_str(kernel)) == 0) {
+                        args.kernels.push_back(kernel);
+                        is_found = true;
+                    }
+                }
+                if (!is_found) {
+                    fprintf(stderr, "Invalid option for kernel: '%s'\n", optarg);
+                    fprintf(stderr, "Run '%s -h' for list of valid kernels for -k\n", argv[0]);
+                    return 1;
+                }
+                break;
+            }
+            case 'n':
+                args.is_normalise_states = true;
+                break;
+            case 'C':
+                args.is_csv = true;
+                break;
+            case 'h':
+                usage();
+                return 0;
+            default: {
+                using R = CLI_Filters_Getopt_Result;
+                const auto res = cli_filters_parse_getopt(args.filters, opt, optarg, argv[0]);
+                if (res == R::ERROR_PARSE) return 1;
+                if (res == R::SUCCESS_EXIT) return 0;
+                if (res == R::NONE) {
+                    usage();
+                    return 1;
+                }
+                break;
+            }
+        }
+    }
+
+    if (args.cell_duration_seconds <= 0.0f) {
+        fprintf(stderr, "Duration of each measurement in seconds must be positive (%.3f)\n", args.cell_duration_seconds);
+        return 1;
+    }
+
+    // Chainback needs enough steps to flush the tail bits for the largest constraint length
+    if (total_steps < int(K_GRID_MAX)) {
+        fprintf(stderr, "Total trellis steps must be >= %zu, got %d\n", K_GRID_MAX, total_steps);
+        return 1;
+    }
+    args.total_steps = size_t(total_steps);
+
+    std::vector<KernelResult> results;
+    run_grid(args, results, std::make_index_sequence<K_GRID_MAX-K_GRID_MIN+1>{});
+
+    if (args.is_csv) {
+        print_csv(results);
+    } else {
+        print_grids(args, results);
+    }
+    return 0;
+}
+
+// Arbitrary polynomials for a synthetic code where the first and last taps are always used
+template <size_t K, size_t R>
+Code<K,R,uint32_t> get_synthetic_code() {
+    Code<K,R,uint32_t> code;
+    code.name = "Synthetic";
+    uint32_t seed = uint32_t(K*131u + R*17u);
+    const uint32_t mask = (uint32_t(1u) << K) - 1u;
+    for (size_t i = 0u; i < R; i++) {
+        seed = seed*1664525u + 1013904223u;
+        code.G[i] = ((seed >> 8u) & mask) | uint32_t(1u) | (uint32_t(1u) << (K-1u));
+    }
+    return code;
+}
+
+template <typename F>
+double measure_median_ns(F&& func, const float duration_seconds) {
+    SampleStatistics stats;
+    const uint64_t total_duration_ns = uint64_t(double(duration_seconds) * 1e9);
+    Timer total_time;
+    while (true) {
+        Timer t;
+        func();
+        stats.push(t.get_delta());
+        if (total_time.get_delta() > total_duration_ns) {
+            break;
+        }
+    }
+    return stats.get_median();
+}
+
+template <size_t K, size_t R>
+void run_code(const Arguments& args, std::vector<KernelResult>& results) {
+    if (!args.allow_K(K) || !args.allow_R(R)) return;
+    fprintf(stderr, "Running K=%zu,R=%zu\n", K, R);
+    const auto code = get_synthetic_code<K,R>();
+    for (const auto decode_type: Decode_Type_List) {
+        if (!args.filters.allow_decode_type(decode_type)) continue;
+        SELECT_DECODE_TYPE(decode_type, {
+            auto config_factory = it0;
+            using factory_t = it1;
+            run_decode_type<factory_t>(code, args, decode_type, config_factory, results);
+        });
+    }
+}
+
+template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void run_decode_type(
+    const Code<K,R,code_t>& code, const Arguments& args, DecodeType decode_type,
+    Decoder_Config<soft_t,error_t>(*config_factory)(const size_t),
+    std::vector<KernelResult>& results
+) {
+    using Core = ViterbiDecoder_Core<K,R,error_t,soft_t>;
+    using BranchTable = ViterbiBranchTable<K,R,soft_t>;
+    const auto config = config_factory(R);
+    auto branch_table = std::make_unique<BranchTable>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
+
+    // Uniformly distributed soft decision values so decisions and renormalisation vary like a noisy channel
+    const size_t total_steps = args.total_steps;
+    const size_t total_symbols = total_steps*R;
+    std::vector<soft_t> symbols;
+    symbols.resize(total_symbols);
+    {
+        const int range = int(config.soft_decision_high) - int(config.soft_decision_low) + 1;
+        for (auto& sym: symbols) {
+            sym = soft_t(int(config.soft_decision_low) + (std::rand() % range));
+        }
+    }
+    // Chainback skips the tail bits at the end of the trellis
+    const size_t total_chainback_bits = total_steps - (K-1u);
+    std::vector<uint8_t> out_bytes;
+    out_bytes.resize((total_chainback_bits+7u)/8u);
+
+    auto push_result = [&](Kernel kernel, const char* simd_name, double ns_per_step) {
+        results.push_back({ kernel, decode_type, simd_name, K, R, ns_per_step });
+    };
+
+    for (const auto simd_type: SIMD_Type_List) {
+        if (!args.filters.allow_simd_type(simd_type)) continue;
+        SELECT_FACTORY_ITEM(factory_t, simd_type, K, R, {
+            using decoder_t = it;
+            using Access = ViterbiDecoder_KernelAccess<decoder_t>;
+            if constexpr(decoder_t::is_valid) {
+                const char* simd_name = get_simd_type_string(simd_type);
+                auto vitdec = std::make_unique<Core>(*branch_table, config.decoder_config);
+                vitdec->set_traceback_length(total_steps);
+
+                if (args.allow_kernel(Kernel::UPDATE)) {
+                    const double ns = measure_median_ns([&]() {
+                        vitdec->reset();
+                        decoder_t::template update<uint64_t>(*vitdec, symbols.data(), total_symbols);
+                    }, args.cell_duration_seconds);
+                    push_result(Kernel::UPDATE, simd_name, ns / double(total_steps));
+                }
+
+                // Butterflies without renormalisation, saturation doesn't change the work done
+                if (args.allow_kernel(Kernel::BFLY)) {
+                    const double ns = measure_median_ns([&]() {
+                        vitdec->reset();
+                        for (size_t s = 0u; s < total_steps; s++) {
+                            auto* decision = vitdec->m_decisions[s];
+                            auto* old_metric = vitdec->m_metrics.get_old();
+                            auto* new_metric = vitdec->m_metrics.get_new();
+                            Access::bfly(*vitdec, &symbols[s*R], decision, old_metric, new_metric);
+                            vitdec->m_metrics.swap();
+                        }
+                    }, args.cell_duration_seconds);
+                    push_result(Kernel::BFLY, simd_name, ns / double(total_steps));
+                }
+
+                if (args.allow_kernel(Kernel::RENORMALISE)) {
+                    vitdec->reset();
+                    auto* metric = vitdec->m_metrics.get_old();
+                    const double ns = measure_median_ns([&]() {
+                        for (size_t s = 0u; s < total_steps; s++) {
+                            Access::renormalise(metric);
+                        }
+                    }, args.cell_duration_seconds);
+                    push_result(Kernel::RENORMALISE, simd_name, ns / double(total_steps));
+                }
+
+                if (args.allow_kernel(Kernel::CHAINBACK)) {
+                    vitdec->reset();
+                    decoder_t::template update<uint64_t>(*vitdec, symbols.data(), total_symbols);
+                    const double ns = measure_median_ns([&]() {
+                        vitdec->chainback(out_bytes.data(), total_chainback_bits, 0u);
+                    }, args.cell_duration_seconds);
+                    push_result(Kernel::CHAINBACK, simd_name, ns / double(total_chainback_bits));
+                }
+            }
+        });
+    }
+}
+
+void print_csv(const std::vector<KernelResult>& results) {
+    printf("kernel,decode_type,simd_type,K,R,total_states,ns_per_step,ns_per_state\n");
+    for (const auto& res: results) {
+        const size_t total_states = size_t(1u) << (res.K-1u);
+        printf("%s,%s,%s,%zu,%zu,%zu,%.4f,%.6f\n",
+            get_kernel_str(res.kernel), get_decode_type_str(res.decode_type), res.simd_name,
+            res.K, res.R, total_states, res.ns_per_step, res.ns_per_step / double(total_states)
+        );
+    }
+}
+
+// Prints a K by R grid for each kernel, decode type and simd type
+// Cells are empty when the decoder doesn't support that constraint length
+void print_grids(const Arguments& args, const std::vector<KernelResult>& results) {
+    struct GridKey {
+        Kernel kernel;
+        DecodeType decode_type;
+        const char* simd_name;
+    };
+    std::vector<GridKey> keys;
+    for (const auto& res: results) {
+        bool is_found = false;
+        for (const auto& key: keys) {
+            if (key.kernel == res.kernel && key.decode_type == res.decode_type && strcmp(key.simd_name, res.simd_name) == 0) {
+                is_found = true;
+                break;
+            }
+        }
+        if (!is_found) keys.push_back({ res.kernel, res.decode_type, res.simd_name });
+    }
+    std::stable_sort(keys.begin(), keys.end(), [](const GridKey& a, const GridKey& b) {
+        if (a.kernel != b.kernel) return a.kernel < b.kernel;
+        return a.decode_type < b.decode_type;
+    });
+
+    for (const auto& key: keys) {
+        printf("kernel=%s,decode=%s,simd=%s,unit=%s\n",
+            get_kernel_str(key.kernel), get_decode_type_str(key.decode_type), key.simd_name,
+            args.is_normalise_states ? "ns/state" : "ns/step"
+        );
+        printf(" K\\R |");
+        for (size_t R = R_GRID_MIN; R <= R_GRID_MAX; R++) {
+            if (!args.allow_R(R)) continue;
+            printf(" %*zu", 10, R);
+        }
+        printf("\n");
+        for (size_t K = K_GRID_MIN; K <= K_GRID_MAX; K++) {
+            if (!args.allow_K(K)) continue;
+            printf(" %3zu |", K);
+            for (size_t R = R_GRID_MIN; R <= R_GRID_MAX; R++) {
+                if (!args.allow_R(R)) continue;
+                const KernelResult* cell = nullptr;
+                for (const auto& res: results) {
+                    if (res.kernel == key.kernel && res.decode_type == key.decode_type &&
+                        strcmp(res.simd_name, key.simd_name) == 0 && res.K == K && res.R == R) {
+                        cell = &res;
+                        break;
+                    }
+                }
+                if (cell == nullptr) {
+                    printf(" %*s", 10, "-");
+                    continue;
+                }
+                const double total_states = double(size_t(1u) << (K-1u));
+                const double value = args.is_normalise_states ? (cell->ns_per_step / total_states) : cell->ns_per_step;
+                printf(" %*.3f", 10, value);
+            }
+            printf("\n");
+        }
+        printf("\n");
+    }
+}
@@ -8,15 +8,18 @@
 #include <random>
 #include <chrono>
 
-#include "viterbi/convolutional_encoder_lookup.h"
+#include "viterbi/convolutional_encoder_templated.h"
 #include "viterbi/viterbi_decoder_core.h"
 
 #include "helpers/decode_type.h"
 #include "helpers/simd_type.h"
 #include "helpers/puncture_code_helpers.h"
+#include "helpers/punctured_hypotheses.h"
 #include "helpers/test_helpers.h"
 #include "utility/console_colours.h"
 #include "utility/span.h"
+#include "utility/timer.h"
+#include "utility/statistics.h"
 #include "getopt/getopt.h"
 
 // DAB radio convolutional code
@@ -74,14 +77,30 @@ const bool* PI_15 = PI_TABLE[15-1u];    // 32bit puncture
 constexpr size_t PI_total_bits = 32;       
 constexpr size_t PI_16_total_count = 21;
 constexpr size_t PI_15_total_count = 3;
+constexpr size_t PI_X_total_bits = 24;
+
+// Compiled puncture codes for the fused encoder
+const auto PI_16_SCHEDULE = PunctureSchedule(PI_16, PI_total_bits, R);
+const auto PI_15_SCHEDULE = PunctureSchedule(PI_15, PI_total_bits, R);
+const auto PI_X_SCHEDULE  = PunctureSchedule(PI_X, PI_X_total_bits, R);
 
 template <class factory_t, typename soft_t, typename error_t>
 void run_test(const Decoder_Config<soft_t,error_t>& config);
 
-template <typename soft_t>
-size_t run_punctured_encoder(
-    ConvolutionalEncoder* enc, 
-    soft_t* output_symbols, const size_t max_output_symbols,
+template <class factory_t, typename soft_t, typename error_t>
+void run_acquisition_test(const Decoder_Config<soft_t,error_t>& config, const uint8_t* tx_input_bytes, const size_t total_data_bytes);
+
+struct BenchmarkArguments {
+    float total_duration_seconds;
+    size_t total_input_bytes;
+};
+
+template <class factory_t, typename soft_t, typename error_t>
+void run_benchmark(const Decoder_Config<soft_t,error_t>& config, const DecodeType decode_type, const BenchmarkArguments& args);
+
+template <typename sink_t>
+void run_punctured_encoder(
+    ConvolutionalEncoderT<K,R>& enc, sink_t& sink,
     const uint8_t* input_bytes, const size_t total_input_bytes
 );
 
@@ -95,6 +114,9 @@ uint64_t run_punctured_decoder(
 void usage() {
     fprintf(stderr, 
         "run_punctured_decoder, Runs viterbi decoder with puncturing on DAB radio code\n\n"
+        "    [-b Benchmark every PI_TABLE protection level instead of running tests]\n"
+        "    [-T <duration_per_level_seconds> (default: 0.1)]\n"
+        "    [-M <total_input_bytes> (default: 96)]\n"
         "    [-h Show usage]\n"
     );
 }
@@ -103,9 +125,21 @@ static size_t total_tests = 0;
 static size_t total_passed_tests = 0;
 
 int main(int argc, char** argv) {
+    bool is_benchmark = false;
+    float total_duration_seconds = 0.1f;
+    int total_input_bytes = 96;
     int opt; 
-    while ((opt = getopt_custom(argc, argv, "h")) != -1) {
+    while ((opt = getopt_custom(argc, argv, "bT:M:h")) != -1) {
         switch (opt) {
+        case 'b':
+            is_benchmark = true;
+            break;
+        case 'T':
+            total_duration_seconds = float(atof(optarg));
+            break;
+        case 'M':
+            total_input_bytes = atoi(optarg);
+            break;
         case 'h':
         default:
             usage();
@@ -113,6 +147,33 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (is_benchmark) {
+        if (total_duration_seconds <= 0.0f) {
+            fprintf(stderr, "Duration per level in seconds must be positive (%.3f)\n", total_duration_seconds);
+            return 1;
+        }
+        if (total_input_bytes <= 0) {
+            fprintf(stderr, "Total input bytes must be > 0, got %d\n", total_input_bytes);
+            return 1;
+        }
+        BenchmarkArguments args;
+        args.total_duration_seconds = total_duration_seconds;
+        args.total_input_bytes = size_t(total_input_bytes);
+        printf("%*s | %*s | %*s | %*s | %*s | %*s | %*s | %*s\n",
+            6, "Decode", 8, "SIMD", 11, "Level", 5, "Rate",
+            8, "Mbit/s", 7, "ns/bit", 10, "overhead %", 6, "errors"
+        );
+        for (const auto& decode_type: Decode_Type_List) {
+            SELECT_DECODE_TYPE(decode_type, {
+                auto get_config = it0;
+                using factory_t = it1;
+                auto config = get_config(R);
+                run_benchmark<factory_t>(config, decode_type, args);
+            });
+        }
+        return 0;
+    }
+
     for (const auto& decode_type: Decode_Type_List) {
         SELECT_DECODE_TYPE(decode_type, {
             auto get_config = it0;
@@ -151,15 +212,31 @@ void run_test(const Decoder_Config<soft_t,error_t>& config) {
     auto output_symbols = std::vector<soft_t>(max_output_symbols);
 
     generate_random_bytes(tx_input_bytes.data(), tx_input_bytes.size());
-    auto enc = ConvolutionalEncoder_Lookup(K, R, G);
+    auto enc = ConvolutionalEncoderT<K,R>(G);
 
     // punctured encoding
-    const size_t total_output_symbols = run_punctured_encoder(
-        &enc, 
-        config.soft_decision_low, config.soft_decision_high,
-        output_symbols.data(), output_symbols.size(),
-        tx_input_bytes.data(), tx_input_bytes.size()
-    );
+    auto sink = SoftSymbolSink<soft_t>(
+        output_symbols.data(), output_symbols.size(), 
+        config.soft_decision_high, config.soft_decision_low);
+    run_punctured_encoder(enc, sink, tx_input_bytes.data(), tx_input_bytes.size());
+    const size_t total_output_symbols = sink.total_symbols;
+
+    // packed bits should match soft decision symbols
+    {
+        auto packed_bytes = std::vector<uint8_t>((total_output_symbols+7u)/8u);
+        auto packed_sink = PackedBitSink(packed_bytes.data(), total_output_symbols);
+        enc.reset();
+        run_punctured_encoder(enc, packed_sink, tx_input_bytes.data(), tx_input_bytes.size());
+        bool is_match = (packed_sink.total_bits == total_output_symbols);
+        for (size_t i = 0u; is_match && (i < total_output_symbols); i++) {
+            const bool bit = (packed_bytes[i/8u] >> (i%8u)) & 0b1;
+            const soft_t symbol = bit ? config.soft_decision_high : config.soft_decision_low;
+            is_match = (symbol == output_symbols[i]);
+        }
+        printf("> Packed bit encoder %s\n\n", is_match ? "matches" : "DOES NOT MATCH");
+        if (is_match) total_passed_tests++;
+        total_tests++;
+    }
 
     // decoding
     auto branch_table = ViterbiBranchTable<K,R,soft_t>(G, config.soft_decision_high, config.soft_decision_low);
@@ -188,61 +265,121 @@ void run_test(const Decoder_Config<soft_t,error_t>& config) {
             }
         });
     }
+
+    run_acquisition_test<factory_t>(config, tx_input_bytes.data(), total_data_bytes);
 }
 
-template <typename soft_t>
-size_t run_punctured_encoder(
-    ConvolutionalEncoder* enc, 
-    const soft_t soft_decision_low, const soft_t soft_decision_high,
-    soft_t* output_symbols, const size_t max_output_symbols,
-    const uint8_t* input_bytes, const size_t total_input_bytes
-) {
-    size_t total_output_symbols = 0u;
-    {
-        auto output_symbols_buf = tcb::span<soft_t>(output_symbols, max_output_symbols);
-        auto input_bytes_buf = tcb::span<const uint8_t>(input_bytes, total_input_bytes);
-        for (size_t i = 0u; i < PI_16_total_count; i++) {
-            const size_t total_bytes = PI_total_bits/8u;
-            const size_t N = encode_punctured_data(
-                enc,
-                input_bytes_buf.data(), total_bytes,
-                output_symbols_buf.data(), output_symbols_buf.size(),
-                PI_16, PI_total_bits,
-                soft_decision_high, soft_decision_low
-            );
-            output_symbols_buf = output_symbols_buf.subspan(N);
-            input_bytes_buf = input_bytes_buf.subspan(total_bytes);
-            total_output_symbols += N;
-        }
+// Receiver has lost track of where the frame starts in the punctured stream
+// Search every stage aligned puncture phase and a few symbol offsets for the alignment with the lowest path error
+template <class factory_t, typename soft_t, typename error_t>
+void run_acquisition_test(const Decoder_Config<soft_t,error_t>& config, const uint8_t* tx_input_bytes, const size_t total_data_bytes) {
+    const bool* puncture_code = PI_TABLE[11-1u];
+    const size_t total_data_bits = total_data_bytes*8u;
+    const size_t total_tail_bits = K-1;
+    const size_t max_output_symbols = (total_data_bits + total_tail_bits)*R;
+    constexpr size_t MAX_SYMBOL_OFFSET = 3u;
+    [[maybe_unused]] constexpr size_t TOTAL_PHASES = PI_total_bits/R;
+    // Decoding whole periods of the puncture code gives every phase the same number of unpunctured symbols
+    // The frame starts at the largest offset so no other hypothesis lines up with it after skipping fewer symbols
+    const size_t true_symbol_offset = MAX_SYMBOL_OFFSET;
+    const size_t true_puncture_phase = 3u*R;
+    assert((total_data_bits % TOTAL_PHASES) == 0u);
 
-        for (size_t i = 0u; i < PI_15_total_count; i++) {
-            const size_t total_bytes = PI_total_bits/8u;
-            const size_t N = encode_punctured_data(
-                enc,
-                input_bytes_buf.data(), total_bytes,
-                output_symbols_buf.data(), output_symbols_buf.size(),
-                PI_15, PI_total_bits,
-                soft_decision_high, soft_decision_low
-            );
-            output_symbols_buf = output_symbols_buf.subspan(N);
-            input_bytes_buf = input_bytes_buf.subspan(total_bytes);
-            total_output_symbols += N;
-        }
+    auto enc = ConvolutionalEncoderT<K,R>(G);
+    auto unpunctured_symbols = std::vector<soft_t>(max_output_symbols);
+    encode_data(
+        enc, 
+        tx_input_bytes, total_data_bytes, 
+        unpunctured_symbols.data(), unpunctured_symbols.size(),
+        config.soft_decision_high, config.soft_decision_low
+    );
 
-        {
-            const size_t N = encode_punctured_tail(
-                enc,
-                output_symbols_buf.data(), output_symbols_buf.size(),
-                PI_X, 24,
-                soft_decision_high, soft_decision_low
-            );
-            total_output_symbols += N;
+    // Junk symbols before the frame don't match either branch leaving the starting state
+    const soft_t junk_symbols[MAX_SYMBOL_OFFSET] = { 
+        config.soft_decision_high, config.soft_decision_low, config.soft_decision_high,
+    };
+    auto rx_symbols = std::vector<soft_t>();
+    rx_symbols.reserve(max_output_symbols + true_symbol_offset);
+    for (size_t i = 0u; i < true_symbol_offset; i++) {
+        rx_symbols.push_back(junk_symbols[i]);
+    }
+    size_t index_puncture_code = true_puncture_phase;
+    for (const auto& symbol: unpunctured_symbols) {
+        if (puncture_code[index_puncture_code]) rx_symbols.push_back(symbol);
+        index_puncture_code = (index_puncture_code+1u) % PI_total_bits;
+    }
+
+    auto hypotheses = std::vector<PunctureHypothesis>();
+    size_t true_index = 0u;
+    for (size_t offset = 0u; offset <= MAX_SYMBOL_OFFSET; offset++) {
+        for (size_t phase = 0u; phase < PI_total_bits; phase += R) {
+            if ((offset == true_symbol_offset) && (phase == true_puncture_phase)) true_index = hypotheses.size();
+            hypotheses.push_back({ offset, phase });
         }
+    }
+
+    auto branch_table = ViterbiBranchTable<K,R,soft_t>(G, config.soft_decision_high, config.soft_decision_low);
+    const soft_t unpunctured_value = 0;
+    for (const auto& simd_type: SIMD_Type_List) {
+        SELECT_FACTORY_ITEM(factory_t, simd_type, K, R, {
+            using decoder_t = it;
+            if constexpr(decoder_t::is_valid) {
+                auto decode_hypotheses = [&](const size_t total_threads) {
+                    return decode_punctured_hypotheses<decoder_t>(
+                        branch_table, config.decoder_config, unpunctured_value,
+                        rx_symbols.data(), rx_symbols.size(),
+                        puncture_code, PI_total_bits,
+                        hypotheses.data(), hypotheses.size(),
+                        total_data_bits, total_threads);
+                };
+                const auto ranked = decode_hypotheses(1u);
+                const auto ranked_threaded = decode_hypotheses(2u);
+
+                bool is_all_complete = true;
+                bool is_threaded_match = ranked.size() == ranked_threaded.size();
+                for (size_t i = 0u; i < ranked.size(); i++) {
+                    is_all_complete = is_all_complete && ranked[i].is_complete;
+                    if (!is_threaded_match) break;
+                    is_threaded_match = 
+                        (ranked[i].index == ranked_threaded[i].index) && 
+                        (ranked[i].error == ranked_threaded[i].error);
+                }
+                const bool is_found = (ranked.size() > 1u) && (ranked[0].index == true_index) && (ranked[0].error < ranked[1].error);
+                const auto& best = hypotheses[ranked[0].index];
+
+                printf("> %s acquisition over %zu hypotheses\n", get_simd_type_string(simd_type), hypotheses.size());
+                printf("best offset=%zu phase=%zu error=%" PRIu64 " (expected offset=%zu phase=%zu)\n", 
+                    best.symbol_offset, best.puncture_phase, ranked[0].error, true_symbol_offset, true_puncture_phase);
+                printf("runner up error=%" PRIu64 " offset=%zu phase=%zu\n", ranked[1].error, hypotheses[ranked[1].index].symbol_offset, hypotheses[ranked[1].index].puncture_phase);
+                printf("threaded ranking %s\n", is_threaded_match ? "matches" : "DOES NOT MATCH");
+                printf("\n");
 
-        assert(input_bytes_buf.size() == 0);
+                if (is_found && is_all_complete && is_threaded_match) total_passed_tests++;
+                total_tests++;
+            }
+        });
+    }
+}
+
+template <typename sink_t>
+void run_punctured_encoder(
+    ConvolutionalEncoderT<K,R>& enc, sink_t& sink,
+    const uint8_t* input_bytes, const size_t total_input_bytes
+) {
+    auto input_bytes_buf = tcb::span<const uint8_t>(input_bytes, total_input_bytes);
+    const size_t total_bytes = PI_total_bits/8u;
+    for (size_t i = 0u; i < PI_16_total_count; i++) {
+        encode_punctured_data(enc, input_bytes_buf.data(), total_bytes, PI_16_SCHEDULE, sink);
+        input_bytes_buf = input_bytes_buf.subspan(total_bytes);
+    }
+
+    for (size_t i = 0u; i < PI_15_total_count; i++) {
+        encode_punctured_data(enc, input_bytes_buf.data(), total_bytes, PI_15_SCHEDULE, sink);
+        input_bytes_buf = input_bytes_buf.subspan(total_bytes);
     }
 
-    return total_output_symbols;
+    encode_punctured_tail(enc, PI_X_SCHEDULE, sink);
+    assert(input_bytes_buf.size() == 0);
 }
 
 template <class decoder_t, typename soft_t, typename error_t>
@@ -276,11 +413,113 @@ uint64_t run_punctured_decoder(
     res = decode_punctured_symbols<decoder_t>(
         vitdec, soft_decision_unpunctured,
         output_symbols_buf.data(), output_symbols_buf.size(), 
-        PI_X, 24, 
-        24);
+        PI_X, PI_X_total_bits, 
+        PI_X_total_bits);
     accumulated_error += res.accumulated_error;
     output_symbols_buf = output_symbols_buf.subspan(res.index_punctured_symbol);
 
     assert(output_symbols_buf.size() == 0u);
     return accumulated_error;
-}
\ No newline at end of file
+}
+
+// Measures end to end decoding of a frame for every protection level
+// The unpunctured baseline calls update() directly so the difference is the cost of depuncturing
+template <class factory_t, typename soft_t, typename error_t>
+void run_benchmark(const Decoder_Config<soft_t,error_t>& config, const DecodeType decode_type, const BenchmarkArguments& args) {
+    constexpr size_t TOTAL_LEVELS = sizeof(PI_TABLE) / sizeof(PI_TABLE[0]);
+    const size_t total_data_bytes = args.total_input_bytes;
+    const size_t total_data_bits = total_data_bytes*8u;
+    const size_t total_tail_bits = K-1;
+    const size_t total_bits = total_data_bits + total_tail_bits;
+    const size_t max_output_symbols = total_bits*R;
+
+    auto tx_input_bytes = std::vector<uint8_t>(total_data_bytes);
+    auto rx_input_bytes = std::vector<uint8_t>(total_data_bytes);
+    generate_random_bytes(tx_input_bytes.data(), tx_input_bytes.size());
+    auto enc = ConvolutionalEncoderT<K,R>(G);
+
+    // Unpunctured symbols followed by the punctured symbols of each level
+    // Every level uses PI_X for the tail
+    std::vector<std::vector<soft_t>> level_symbols;
+    level_symbols.resize(TOTAL_LEVELS+1u);
+    level_symbols[0].resize(max_output_symbols);
+    enc.reset();
+    encode_data(
+        enc, 
+        tx_input_bytes.data(), tx_input_bytes.size(), 
+        level_symbols[0].data(), level_symbols[0].size(),
+        config.soft_decision_high, config.soft_decision_low
+    );
+    for (size_t level = 1u; level <= TOTAL_LEVELS; level++) {
+        auto& symbols = level_symbols[level];
+        symbols.resize(max_output_symbols);
+        const auto schedule = PunctureSchedule(PI_TABLE[level-1u], PI_total_bits, R);
+        auto sink = SoftSymbolSink<soft_t>(symbols.data(), symbols.size(), config.soft_decision_high, config.soft_decision_low);
+        enc.reset();
+        encode_punctured_data(enc, tx_input_bytes.data(), tx_input_bytes.size(), schedule, sink);
+        encode_punctured_tail(enc, PI_X_SCHEDULE, sink);
+        symbols.resize(sink.total_symbols);
+    }
+
+    auto branch_table = ViterbiBranchTable<K,R,soft_t>(G, config.soft_decision_high, config.soft_decision_low);
+    auto vitdec = ViterbiDecoder_Core<K,R,error_t,soft_t>(branch_table, config.decoder_config);
+    const soft_t unpunctured_value = 0;
+    vitdec.set_traceback_length(total_data_bits);
+
+    for (const auto& simd_type: SIMD_Type_List) {
+        SELECT_FACTORY_ITEM(factory_t, simd_type, K, R, {
+            using decoder_t = it;
+            if constexpr(decoder_t::is_valid) {
+                auto decode_level = [&](const size_t level) {
+                    const auto& symbols = level_symbols[level];
+                    vitdec.reset();
+                    if (level == 0u) {
+                        decoder_t::template update<uint64_t>(vitdec, symbols.data(), symbols.size());
+                    } else {
+                        const auto res = decode_punctured_symbols<decoder_t>(
+                            vitdec, unpunctured_value,
+                            symbols.data(), symbols.size(), 
+                            PI_TABLE[level-1u], PI_total_bits, 
+                            total_data_bits*R);
+                        decode_punctured_symbols<decoder_t>(
+                            vitdec, unpunctured_value,
+                            symbols.data()+res.index_punctured_symbol, symbols.size()-res.index_punctured_symbol, 
+                            PI_X, PI_X_total_bits, 
+                            total_tail_bits*R);
+                    }
+                    vitdec.chainback(rx_input_bytes.data(), total_data_bits, 0u);
+                };
+
+                double baseline_mean_ns = 0.0;
+                for (size_t level = 0u; level <= TOTAL_LEVELS; level++) {
+                    decode_level(level);
+                    const size_t total_errors = get_total_bit_errors(tx_input_bytes.data(), rx_input_bytes.data(), total_data_bytes);
+
+                    SampleStatistics stats;
+                    Timer total_time;
+                    while (float(total_time.get_delta<std::chrono::microseconds>())*1e-6f < args.total_duration_seconds) {
+                        Timer t;
+                        decode_level(level);
+                        stats.push(t.get_delta());
+                    }
+
+                    const double mean_ns = stats.get_mean();
+                    if (level == 0u) baseline_mean_ns = mean_ns;
+                    const double code_rate = double(total_bits) / double(level_symbols[level].size());
+                    char level_str[16];
+                    if (level == 0u) {
+                        snprintf(level_str, sizeof(level_str), "unpunctured");
+                    } else {
+                        snprintf(level_str, sizeof(level_str), "PI_%zu", level);
+                    }
+                    printf("%*s | %*s | %*s | %*.3f | %*.2f | %*.3f | %*.2f | %*zu\n",
+                        6, get_decode_type_str(decode_type), 8, get_simd_type_string(simd_type),
+                        11, level_str, 5, code_rate,
+                        8, double(total_data_bits) / mean_ns * 1e3, 7, mean_ns / double(total_data_bits),
+                        10, (mean_ns / baseline_mean_ns - 1.0) * 100.0, 6, total_errors
+                    );
+                }
+            }
+        });
+    }
+}
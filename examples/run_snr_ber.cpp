@@ -6,22 +6,27 @@
 #include <inttypes.h>
 #include <vector>
 #include <map>
-#include <random>
+#include <string>
+#include <tuple>
 #include <optional>
+#include <memory>
+#include <mutex>
 
-#include "viterbi/convolutional_encoder.h"
-#include "viterbi/convolutional_encoder_shift_register.h"
+#include "viterbi/convolutional_encoder_templated.h"
 #include "viterbi/viterbi_decoder_core.h"
 
 #include "helpers/common_codes.h"
 #include "helpers/simd_type.h"
 #include "helpers/decode_type.h"
 #include "helpers/test_helpers.h"
+#include "helpers/channel_model.h"
 #include "helpers/cli_filters.h"
 #include "getopt/getopt.h"
 #include "utility/span.h"
 #include "utility/thread_pool.h"
 #include "utility/timer.h"
+#include "utility/statistics.h"
+#include "utility/flat_json.h"
 
 struct TestRange {
     float EbNo_dB_initial;
@@ -33,20 +38,126 @@ struct Arguments {
     size_t maximum_error_bits;
     size_t traceback_length_bytes;
     size_t maximum_data_points;
+    size_t blocks_per_work_item;
     uint64_t random_seed;
     float maximum_generated_bits_scale;
     std::optional<float> timeout_seconds;
+    // Stop a point once the confidence intervals are narrow enough instead of at a fixed error count
+    std::optional<float> relative_precision;
+    float confidence_level;
+    double critical_value;
+    std::optional<std::string> checkpoint_filename;
+    bool is_resume;
     CLI_Filters filters;
 };
 
-struct TestResults {
-    std::vector<float> EbNo_dB;
-    std::vector<float> bit_error_rates;
-    std::vector<size_t> total_bit_errors;
-    std::vector<size_t> total_bits;
+// Errors from a batch of consecutive blocks at a single Eb/No point
+// Each block is a frame which is in error if any of its bits are wrong
+struct BatchResult {
+    size_t total_bit_errors = 0;
+    // Sum over frames of the squared number of bit errors in each frame for the variance between frames
+    uint64_t total_squared_frame_bit_errors = 0;
+    size_t total_bits = 0;
+    size_t total_frame_errors = 0;
+    size_t total_frames = 0;
+};
+
+// Each (code, decode, simd) sweep is split into work items of a few blocks at one Eb/No point
+// Work items run on any thread and their results are merged in block order
+// A point stops at the first batch where the merged totals meet the stopping criteria
+// so the results don't depend on the number of threads or the order items finish in
+struct PointState {
+    float EbNo_dB = 0.0f;
+    size_t maximum_batches = 0;
+    size_t total_issued_batches = 0;
+    size_t total_merged_batches = 0;
+    std::vector<std::optional<BatchResult>> batches;
+    BatchResult merged;
+    bool is_resolved = false;
+    bool is_timeout = false;
+    std::unique_ptr<Timer> timer = nullptr;
+    uint64_t last_checkpoint_ns = 0;
+};
+
+// Checkpoints are JSON-lines with a "run" record followed by "point" records
+// Work items are seeded from (random_seed, point_index, batch_index) so the merged batch count
+// is all the random state needed to continue a point exactly where it stopped
+// Later point records replace earlier ones so a resumed run only needs the latest of each
+// The run record holds every argument that changes which batches are merged into a point
+struct CheckpointRun {
+    uint64_t random_seed = 0;
+    size_t traceback_length_bytes = 0;
+    size_t blocks_per_work_item = 0;
+    size_t maximum_error_bits = 0;
+    size_t maximum_data_points = 0;
+    float maximum_generated_bits_scale = 0.0f;
+    // Zero if the point stops at maximum_error_bits instead
+    float relative_precision = 0.0f;
+    float confidence_level = 0.0f;
+};
+
+struct CheckpointPoint {
+    float EbNo_dB = 0.0f;
+    size_t total_merged_batches = 0;
+    BatchResult merged;
+    bool is_resolved = false;
+    bool is_timeout = false;
+};
+
+// (code name, decode type, simd type, point index)
+using CheckpointKey = std::tuple<std::string, std::string, std::string, size_t>;
+
+// Unresolved points are checkpointed at most this often to keep the file small
+static constexpr uint64_t CHECKPOINT_INTERVAL_NS = uint64_t(10e9);
+
+// Decoder, encoder and buffers used by a work item
+// These are reused between work items of the same sweep to avoid reallocating the decisions
+template <size_t K, size_t R, typename error_t, typename soft_t>
+struct BlockContext {
+    ViterbiDecoder_Core<K,R,error_t,soft_t> vitdec;
+    ConvolutionalEncoderT<K,R> enc;
+    std::vector<uint8_t> tx_block_bytes;
+    std::vector<uint8_t> rx_block_bytes;
+    std::vector<float> output_symbols_float;
+    std::vector<soft_t> output_symbols;
+
+    template <typename code_t>
+    BlockContext(const ViterbiBranchTable<K,R,soft_t>& branch_table, const ViterbiDecoder_Config<error_t>& config, const code_t* G)
+    : vitdec(branch_table, config), enc(G) {}
+};
+
+template <size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+struct SweepState {
+    using Context = BlockContext<K,R,error_t,soft_t>;
+    const Code<K,R,code_t> code;
+    const DecodeType decode_type;
+    const SIMD_Type simd_type;
+    const Decoder_Config<soft_t,error_t> config;
+    const ViterbiBranchTable<K,R,soft_t> branch_table;
+    std::mutex mutex;
+    std::vector<PointState> points;
+    std::vector<std::unique_ptr<Context>> free_contexts;
+    size_t total_in_flight = 0;
+    // Index of the point that ended the sweep
+    std::optional<size_t> last_point = std::nullopt;
+    // Points are printed in order once every point before them has resolved
+    size_t total_printed_points = 0;
+    bool is_printed = false;
+
+    SweepState(const Code<K,R,code_t>& _code, const DecodeType _decode_type, const SIMD_Type _simd_type, const Decoder_Config<soft_t,error_t>& _config)
+    : code(_code), decode_type(_decode_type), simd_type(_simd_type), config(_config),
+      branch_table(_code.G.data(), _config.soft_decision_high, _config.soft_decision_low) {}
 };
 
 TestRange get_test_range(const size_t K, const size_t R);
+size_t get_maximum_generated_bits(const size_t K, const size_t R, const Arguments& args);
+PointState create_point(const size_t point_index, const size_t K, const size_t R, const Arguments& args);
+bool is_point_precise(const BatchResult& result, const Arguments& args);
+bool is_last_point(const PointState& point, const size_t point_index, const Arguments& args);
+std::optional<CheckpointRun> load_checkpoint(const char* filename);
+void write_checkpoint_run(const Arguments& args);
+bool is_missing_trailing_newline(const char* filename);
+uint64_t get_work_item_seed(const uint64_t random_seed, const size_t point_index, const size_t batch_index);
 
 template <size_t K, size_t R, typename code_t>
 void select_decode_type(const Code<K,R,code_t>& code, const size_t code_id, const Arguments& args);
@@ -58,24 +169,42 @@ void run_tests(
     const Arguments& args
 );
 
-template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t, typename code_t>
-TestResults run_test(
-    ViterbiDecoder_Core<K,R,error_t,soft_t>& vitdec, ConvolutionalEncoder* enc, 
-    const soft_t soft_decision_high, const soft_t soft_decision_low,
-    const Arguments& args, const TestRange& test_range, 
-    const Code<K,R,code_t>& code, const DecodeType decode_type, const SIMD_Type simd_type, const size_t thread_id
+template <class decoder_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void start_sweep(
+    const Code<K,R,code_t>& code, const DecodeType decode_type, const SIMD_Type simd_type,
+    const Decoder_Config<soft_t,error_t>& config, const Arguments& args
 );
 
-template <size_t K, size_t R, typename code_t>
-void print_test_results(
-    FILE* fp_out, 
-    const Code<K,R,code_t>& code, 
-    const DecodeType decode_type, const SIMD_Type simd_type,
-    const TestResults& results
+template <class decoder_t, size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+void issue_work_items(const std::shared_ptr<SweepState<K,R,code_t,error_t,soft_t>>& sweep, const Arguments& args);
+
+template <class decoder_t, size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+void run_work_item(
+    const std::shared_ptr<SweepState<K,R,code_t,error_t,soft_t>>& sweep, const Arguments& args,
+    const size_t point_index, const size_t batch_index, const size_t thread_id
 );
 
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+BatchResult run_batch(
+    BlockContext<K,R,error_t,soft_t>& ctx,
+    const soft_t soft_decision_high, const soft_t soft_decision_low,
+    const float EbNo_dB, const uint64_t seed, const size_t total_blocks
+);
+
+template <size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+size_t restore_points(SweepState<K,R,code_t,error_t,soft_t>& sweep, const Arguments& args);
+
+template <size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+void write_checkpoint_point(const SweepState<K,R,code_t,error_t,soft_t>& sweep, const size_t point_index);
+
+template <size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+bool print_resolved_points(SweepState<K,R,code_t,error_t,soft_t>& sweep, const Arguments& args);
+
+template <size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+void print_point_result(FILE* fp_out, const SweepState<K,R,code_t,error_t,soft_t>& sweep, const size_t point_index, const Arguments& args);
+
 void usage() {
-    fprintf(stderr, 
+    fprintf(stderr,
         "run_tests, Runs all tests\n\n"
         "    [-t <total_threads> (default: 0)]\n"
         "    [-L <traceback_length> (default: 512)]\n"
@@ -84,6 +213,11 @@ void usage() {
         "    [-S <random_seed> (default: 0) ]\n"
         "    [-k <maximum_generated_bits_scale> (default: 1.0)]\n"
         "    [-T <timeout_seconds> (default: None)]\n"
+        "    [-B <blocks_per_work_item> (default: 8)]\n"
+        "    [-P <relative_precision> (default: None)]\n"
+        "    [-C <confidence_level> (default: 0.95)]\n"
+        "    [-o <checkpoint_filename> (default: None)]\n"
+        "    [-r Resume from the checkpoint given by -o]\n"
     );
     cli_filters_print_usage();
     fprintf(stderr,
@@ -92,22 +226,29 @@ void usage() {
 }
 
 static std::unique_ptr<ThreadPool> thread_pool = nullptr;
-static bool g_is_first_result = true;
 static std::mutex mutex_stderr;
 static std::mutex mutex_fp_out;
 static FILE* fp_out = stdout;
+static std::mutex mutex_fp_checkpoint;
+static FILE* fp_checkpoint = nullptr;
+static std::map<CheckpointKey, CheckpointPoint> g_checkpoint_points;
 
 int main(int argc, char** argv) {
     int total_threads = 0;
     int traceback_length = 512;
     int maximum_error_bits = 1024;
     int maximum_data_points = 30;
+    int blocks_per_work_item = 8;
     float maximum_generated_bits_scale = 1.0f;
     std::optional<float> timeout_seconds = std::nullopt;
+    std::optional<float> relative_precision = std::nullopt;
+    float confidence_level = 0.95f;
+    const char* checkpoint_filename = nullptr;
+    bool is_resume = false;
     int random_seed = 0;
     CLI_Filters filters;
     while (true) {
-        const int opt = getopt_custom(argc, argv, "t:L:n:D:S:k:T:h" CLI_FILTERS_GETOPT_STRING);
+        const int opt = getopt_custom(argc, argv, "t:L:n:D:S:k:T:B:P:C:o:rh" CLI_FILTERS_GETOPT_STRING);
         if (opt == -1) break;
         switch (opt) {
             case 't':
@@ -131,6 +272,21 @@ int main(int argc, char** argv) {
             case 'T':
                 timeout_seconds = std::optional(float(atof(optarg)));
                 break;
+            case 'B':
+                blocks_per_work_item = atoi(optarg);
+                break;
+            case 'P':
+                relative_precision = std::optional(float(atof(optarg)));
+                break;
+            case 'C':
+                confidence_level = float(atof(optarg));
+                break;
+            case 'o':
+                checkpoint_filename = optarg;
+                break;
+            case 'r':
+                is_resume = true;
+                break;
             case 'h':
                 usage();
                 return 0;
@@ -168,6 +324,11 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    if (blocks_per_work_item <= 0) {
+        fprintf(stderr, "Blocks per work item must be > 0, got %d\n", blocks_per_work_item);
+        return 1;
+    }
+
     if (random_seed < 0) {
         fprintf(stderr, "Random seed must be >= 0, got %d\n", random_seed);
         return 1;
@@ -182,37 +343,120 @@ int main(int argc, char** argv) {
         fprintf(stderr, "Timeout must be > 0, got %f\n", timeout_seconds.value());
         return 1;
     }
- 
+
+    if (relative_precision.has_value() && relative_precision.value() <= 0.0f) {
+        fprintf(stderr, "Relative precision must be > 0, got %f\n", relative_precision.value());
+        return 1;
+    }
+
+    if (confidence_level <= 0.0f || confidence_level >= 1.0f) {
+        fprintf(stderr, "Confidence level must be between 0 and 1, got %f\n", confidence_level);
+        return 1;
+    }
+
+    if (is_resume && checkpoint_filename == nullptr) {
+        fprintf(stderr, "Resuming requires a checkpoint file given by -o\n");
+        return 1;
+    }
+
     Arguments args;
     args.traceback_length_bytes = size_t(traceback_length);
     args.maximum_error_bits = size_t(maximum_error_bits);
     args.maximum_data_points = size_t(maximum_data_points);
+    args.blocks_per_work_item = size_t(blocks_per_work_item);
     args.maximum_generated_bits_scale = maximum_generated_bits_scale;
     args.random_seed = 0;
     args.timeout_seconds = timeout_seconds;
+    args.relative_precision = relative_precision;
+    args.confidence_level = confidence_level;
+    args.critical_value = get_normal_critical_value(double(confidence_level));
+    args.checkpoint_filename = std::nullopt;
+    args.is_resume = is_resume;
     args.filters = filters;
+    if (checkpoint_filename != nullptr) {
+        args.checkpoint_filename = std::string(checkpoint_filename);
+    }
     if (random_seed == 0) {
         args.random_seed = uint64_t(time(NULL));
     } else {
         args.random_seed = uint64_t(random_seed);
     }
 
+    std::optional<CheckpointRun> checkpoint_run = std::nullopt;
+    if (is_resume) {
+        checkpoint_run = load_checkpoint(checkpoint_filename);
+        if (!checkpoint_run.has_value()) {
+            fprintf(stderr, "Starting a new checkpoint since '%s' has no run to resume\n", checkpoint_filename);
+        }
+    }
+    if (checkpoint_run.has_value()) {
+        const auto& run = checkpoint_run.value();
+        // The random streams depend on these so they have to match the original run
+        if (random_seed != 0 && uint64_t(random_seed) != run.random_seed) {
+            fprintf(stderr, "Random seed %d doesn't match checkpoint seed %" PRIu64 "\n", random_seed, run.random_seed);
+            return 1;
+        }
+        if (run.traceback_length_bytes != args.traceback_length_bytes) {
+            fprintf(stderr, "Traceback length %zu doesn't match checkpoint value %zu\n", args.traceback_length_bytes, run.traceback_length_bytes);
+            return 1;
+        }
+        if (run.blocks_per_work_item != args.blocks_per_work_item) {
+            fprintf(stderr, "Blocks per work item %zu doesn't match checkpoint value %zu\n", args.blocks_per_work_item, run.blocks_per_work_item);
+            return 1;
+        }
+        // The stopping criteria decide which batches were merged into each checkpointed point
+        if (run.maximum_error_bits != args.maximum_error_bits) {
+            fprintf(stderr, "Maximum error bits %zu doesn't match checkpoint value %zu\n", args.maximum_error_bits, run.maximum_error_bits);
+            return 1;
+        }
+        if (run.maximum_data_points != args.maximum_data_points) {
+            fprintf(stderr, "Maximum data points %zu doesn't match checkpoint value %zu\n", args.maximum_data_points, run.maximum_data_points);
+            return 1;
+        }
+        if (run.maximum_generated_bits_scale != args.maximum_generated_bits_scale) {
+            fprintf(stderr, "Maximum generated bits scale %f doesn't match checkpoint value %f\n", args.maximum_generated_bits_scale, run.maximum_generated_bits_scale);
+            return 1;
+        }
+        if (run.relative_precision != args.relative_precision.value_or(0.0f)) {
+            fprintf(stderr, "Relative precision %f doesn't match checkpoint value %f (0 if unset)\n", args.relative_precision.value_or(0.0f), run.relative_precision);
+            return 1;
+        }
+        if (run.confidence_level != args.confidence_level) {
+            fprintf(stderr, "Confidence level %f doesn't match checkpoint value %f\n", args.confidence_level, run.confidence_level);
+            return 1;
+        }
+        args.random_seed = run.random_seed;
+        fprintf(stderr, "Resuming %zu checkpointed points from '%s'\n", g_checkpoint_points.size(), checkpoint_filename);
+    }
+    if (checkpoint_filename != nullptr) {
+        const bool is_newline_needed = checkpoint_run.has_value() && is_missing_trailing_newline(checkpoint_filename);
+        fp_checkpoint = fopen(checkpoint_filename, checkpoint_run.has_value() ? "a" : "w");
+        if (fp_checkpoint == nullptr) {
+            fprintf(stderr, "Failed to open checkpoint file '%s'\n", checkpoint_filename);
+            return 1;
+        }
+        if (is_newline_needed) {
+            fprintf(fp_checkpoint, "\n");
+        }
+        if (!checkpoint_run.has_value()) {
+            write_checkpoint_run(args);
+        }
+    }
+
     thread_pool = std::make_unique<ThreadPool>(size_t(total_threads));
- 
+    fprintf(stderr, "Using %zu threads with random seed %" PRIu64 "\n", thread_pool->get_total_threads(), args.random_seed);
+    // Work items push further work items as they finish and each point is printed as a JSON line once resolved
+
     size_t code_id = 0;
     FOR_COMMON_CODES({
         const auto& code = it;
         select_decode_type(code, code_id, args);
         code_id++;
     });
- 
-    const int total_tasks = thread_pool->get_total_tasks();
-    fprintf(stderr, "Using %zu threads\n", thread_pool->get_total_threads());
-    fprintf(stderr, "Total tasks in thread pool: %d\n", total_tasks);
-    if (total_tasks > 0) {
-        fprintf(fp_out, "[\n");
-        thread_pool->wait_all();
-        fprintf(fp_out, "]\n");
+
+    thread_pool->wait_all();
+    if (fp_checkpoint != nullptr) {
+        fclose(fp_checkpoint);
     }
     return 0;
 }
@@ -224,7 +468,7 @@ TestRange get_test_range(const size_t K, const size_t R) {
     // runtime ∝ R * 2^(K-1)
     const size_t runtime_scale = R * (size_t(1u)<<(K-1));
     const size_t error_correcting_capability = K*R;
-    size_t base_total_bits = size_t(1e9); 
+    size_t base_total_bits = size_t(1e9);
     TestRange range;
     range.EbNo_dB_initial = 0.0f;
     range.EbNo_dB_step = 0.5f;
@@ -232,6 +476,157 @@ TestRange get_test_range(const size_t K, const size_t R) {
     return range;
 }
 
+size_t get_maximum_generated_bits(const size_t K, const size_t R, const Arguments& args) {
+    const auto test_range = get_test_range(K,R);
+    return size_t(std::ceil(args.maximum_generated_bits_scale*float(test_range.maximum_generated_bits)));
+}
+
+PointState create_point(const size_t point_index, const size_t K, const size_t R, const Arguments& args) {
+    const auto test_range = get_test_range(K,R);
+    const size_t total_block_bits = args.traceback_length_bytes*8u;
+    const size_t batch_bits = total_block_bits*args.blocks_per_work_item;
+    const size_t max_generated_bits = get_maximum_generated_bits(K, R, args);
+    PointState point;
+    point.EbNo_dB = test_range.EbNo_dB_initial + float(point_index)*test_range.EbNo_dB_step;
+    point.maximum_batches = max(size_t(1u), (max_generated_bits + batch_bits - 1u) / batch_bits);
+    point.timer = std::make_unique<Timer>();
+    return point;
+}
+
+// Bit errors from a Viterbi decoder arrive in bursts so bits aren't independent trials
+// The interval is widened by the variance of the number of bit errors between frames, which are independent
+ProportionInterval get_ber_interval(const BatchResult& result, const Arguments& args) {
+    if (result.total_frames == 0u) return ProportionInterval{};
+    const size_t total_frame_bits = result.total_bits / result.total_frames;
+    return get_clustered_wilson_interval(
+        result.total_bit_errors, result.total_squared_frame_bit_errors,
+        result.total_frames, total_frame_bits, args.critical_value);
+}
+
+ProportionInterval get_fer_interval(const BatchResult& result, const Arguments& args) {
+    return get_wilson_interval(result.total_frame_errors, result.total_frames, args.critical_value);
+}
+
+bool is_point_precise(const BatchResult& result, const Arguments& args) {
+    if (!args.relative_precision.has_value()) return false;
+    const double target = double(args.relative_precision.value());
+    const auto ber = get_ber_interval(result, args);
+    const auto fer = get_fer_interval(result, args);
+    return (ber.get_relative_precision() <= target) && (fer.get_relative_precision() <= target);
+}
+
+// The sweep ends at a point without errors since later points would have none either
+bool is_last_point(const PointState& point, const size_t point_index, const Arguments& args) {
+    return
+        (point.merged.total_bit_errors == 0) ||
+        (point_index >= args.maximum_data_points) ||
+        point.is_timeout;
+}
+
+std::optional<CheckpointRun> load_checkpoint(const char* filename) {
+    FILE* fp = fopen(filename, "r");
+    if (fp == nullptr) return std::nullopt;
+    std::optional<CheckpointRun> run = std::nullopt;
+    std::string line;
+    char buffer[512];
+    while (fgets(buffer, sizeof(buffer), fp) != nullptr) {
+        line.append(buffer);
+        if (line.back() != '\n' && !feof(fp)) continue;
+        // A line cut short by preemption fails to parse and is skipped
+        const auto record = FlatJsonObject::parse(line.c_str());
+        line.clear();
+        if (!record.has_value()) continue;
+        const auto type = record->get_string("type");
+        if (!type.has_value()) continue;
+        if (type.value() == "run") {
+            const auto random_seed = record->get_uint("random_seed");
+            const auto traceback_length = record->get_uint("traceback_length");
+            const auto blocks_per_work_item = record->get_uint("blocks_per_work_item");
+            const auto maximum_error_bits = record->get_uint("maximum_error_bits");
+            const auto maximum_data_points = record->get_uint("maximum_data_points");
+            const auto maximum_generated_bits_scale = record->get_double("maximum_generated_bits_scale");
+            const auto relative_precision = record->get_double("relative_precision");
+            const auto confidence_level = record->get_double("confidence_level");
+            if (!random_seed || !traceback_length || !blocks_per_work_item) continue;
+            if (!maximum_error_bits || !maximum_data_points || !maximum_generated_bits_scale || !relative_precision || !confidence_level) continue;
+            CheckpointRun r;
+            r.random_seed = random_seed.value();
+            r.traceback_length_bytes = size_t(traceback_length.value());
+            r.blocks_per_work_item = size_t(blocks_per_work_item.value());
+            r.maximum_error_bits = size_t(maximum_error_bits.value());
+            r.maximum_data_points = size_t(maximum_data_points.value());
+            r.maximum_generated_bits_scale = float(maximum_generated_bits_scale.value());
+            r.relative_precision = float(relative_precision.value());
+            r.confidence_level = float(confidence_level.value());
+            run = r;
+        } else if (type.value() == "point") {
+            const auto name = record->get_string("name");
+            const auto decode_type = record->get_string("decode_type");
+            const auto simd_type = record->get_string("simd_type");
+            const auto point_index = record->get_uint("point_index");
+            const auto EbNo_dB = record->get_double("EbNo_dB");
+            const auto total_merged_batches = record->get_uint("total_merged_batches");
+            const auto total_bit_errors = record->get_uint("total_bit_errors");
+            const auto total_squared_frame_bit_errors = record->get_uint("total_squared_frame_bit_errors");
+            const auto total_bits = record->get_uint("total_bits");
+            const auto total_frame_errors = record->get_uint("total_frame_errors");
+            const auto total_frames = record->get_uint("total_frames");
+            const auto is_resolved = record->get_bool("is_resolved");
+            const auto is_timeout = record->get_bool("is_timeout");
+            if (!name || !decode_type || !simd_type || !point_index || !EbNo_dB || !total_merged_batches) continue;
+            if (!total_bit_errors || !total_squared_frame_bit_errors || !total_bits || !total_frame_errors || !total_frames || !is_resolved || !is_timeout) continue;
+            CheckpointPoint point;
+            point.EbNo_dB = float(EbNo_dB.value());
+            point.total_merged_batches = size_t(total_merged_batches.value());
+            point.merged.total_bit_errors = size_t(total_bit_errors.value());
+            point.merged.total_squared_frame_bit_errors = total_squared_frame_bit_errors.value();
+            point.merged.total_bits = size_t(total_bits.value());
+            point.merged.total_frame_errors = size_t(total_frame_errors.value());
+            point.merged.total_frames = size_t(total_frames.value());
+            point.is_resolved = is_resolved.value();
+            point.is_timeout = is_timeout.value();
+            const auto key = CheckpointKey{name.value(), decode_type.value(), simd_type.value(), size_t(point_index.value())};
+            g_checkpoint_points[key] = point;
+        }
+    }
+    fclose(fp);
+    // Points without a run record can't be resumed since their random streams are unknown
+    if (!run.has_value()) g_checkpoint_points.clear();
+    return run;
+}
+
+// Floats are written with enough digits to be read back exactly
+void write_checkpoint_run(const Arguments& args) {
+    auto lock = std::scoped_lock(mutex_fp_checkpoint);
+    fprintf(fp_checkpoint,
+        "{\"type\": \"run\", \"random_seed\": %" PRIu64 ", \"traceback_length\": %zu, \"blocks_per_work_item\": %zu, "
+        "\"maximum_error_bits\": %zu, \"maximum_data_points\": %zu, \"maximum_generated_bits_scale\": %.9g, "
+        "\"relative_precision\": %.9g, \"confidence_level\": %.9g}\n",
+        args.random_seed, args.traceback_length_bytes, args.blocks_per_work_item,
+        args.maximum_error_bits, args.maximum_data_points, double(args.maximum_generated_bits_scale),
+        double(args.relative_precision.value_or(0.0f)), double(args.confidence_level)
+    );
+    fflush(fp_checkpoint);
+}
+
+// A line cut short by preemption has no trailing newline and the next record would be appended onto it
+bool is_missing_trailing_newline(const char* filename) {
+    FILE* fp = fopen(filename, "rb");
+    if (fp == nullptr) return false;
+    bool is_missing = false;
+    if (fseek(fp, -1, SEEK_END) == 0) {
+        is_missing = (fgetc(fp) != '\n');
+    }
+    fclose(fp);
+    return is_missing;
+}
+
+// Counter based seeding gives every work item an independent random stream
+// regardless of which thread runs it or when
+uint64_t get_work_item_seed(const uint64_t random_seed, const size_t point_index, const size_t batch_index) {
+    return splitmix64(splitmix64(splitmix64(random_seed) ^ uint64_t(point_index)) ^ uint64_t(batch_index));
+}
+
 template <size_t K, size_t R, typename code_t>
 void select_decode_type(const Code<K,R,code_t>& code, const size_t code_id, const Arguments& args) {
     if (!args.filters.allow_code_index(code_id)) return;
@@ -252,151 +647,324 @@ void run_tests(
     Decoder_Config<soft_t,error_t>(*config_factory)(const size_t),
     const Arguments& args
 ) {
+    const Decoder_Config<soft_t, error_t> config = config_factory(code.R);
     for (const auto& simd_type: SIMD_Type_List) {
         if (!args.filters.allow_simd_type(simd_type)) continue;
         SELECT_FACTORY_ITEM(factory_t, simd_type, K, R, {
             using decoder_t = it;
             if constexpr(decoder_t::is_valid) {
-                thread_pool->push_task([=](size_t thread_id) {
-                    const Decoder_Config<soft_t, error_t> config = config_factory(code.R);
-                    auto branch_table = ViterbiBranchTable<K,R,soft_t>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
-                    auto enc = ConvolutionalEncoder_ShiftRegister(code.K, code.R, code.G.data());
-                    auto vitdec = ViterbiDecoder_Core<K,R,error_t,soft_t>(branch_table, config.decoder_config);
-                    const auto test_range = get_test_range(K,R);
-                    const auto test_results = run_test<decoder_t>(
-                        vitdec, &enc, 
-                        config.soft_decision_high, config.soft_decision_low,
-                        args, test_range, 
-                        code, decode_type, simd_type, thread_id
-                    ); 
-                    auto lock_fp_out = std::scoped_lock(mutex_fp_out);
-                    print_test_results(fp_out, code, decode_type, simd_type, test_results);
-                });
-            } 
+                start_sweep<decoder_t>(code, decode_type, simd_type, config, args);
+            }
         });
     }
 }
 
-template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t, typename code_t>
-TestResults run_test(
-    ViterbiDecoder_Core<K,R,error_t,soft_t>& vitdec, ConvolutionalEncoder* enc, 
-    const soft_t soft_decision_high, const soft_t soft_decision_low,
-    const Arguments& args, const TestRange& test_range, 
-    const Code<K,R,code_t>& code, const DecodeType decode_type, const SIMD_Type simd_type, const size_t thread_id
+template <class decoder_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void start_sweep(
+    const Code<K,R,code_t>& code, const DecodeType decode_type, const SIMD_Type simd_type,
+    const Decoder_Config<soft_t,error_t>& config, const Arguments& args
 ) {
-    assert(vitdec.K == enc->K);
-    assert(vitdec.R == enc->R);
-    // determine size of buffers per block
-    const size_t total_block_bytes = args.traceback_length_bytes;
-    const size_t total_block_bits = total_block_bytes*8u;
-    size_t total_block_symbols = 0;
-    {
-        const size_t total_tail_bits = K-1u;
-        const size_t total_data_bits = total_block_bytes*8;
-        const size_t total_bits = total_data_bits + total_tail_bits;
-        total_block_symbols = total_bits * R;
+    using Sweep = SweepState<K,R,code_t,error_t,soft_t>;
+    auto sweep = std::make_shared<Sweep>(code, decode_type, simd_type, config);
+    if (args.is_resume) {
+        auto lock = std::scoped_lock(sweep->mutex);
+        const size_t total_restored = restore_points(*sweep, args);
+        if (total_restored > 0) {
+            auto lock_stderr = std::scoped_lock(mutex_stderr);
+            fprintf(stderr, "Restored %zu points for name='%s',decode=%s,simd=%s\n",
+                total_restored, code.name, get_decode_type_str(decode_type), get_simd_type_string(simd_type));
+        }
+        if (print_resolved_points(*sweep, args)) return;
     }
-    // setup buffers to generate data in blocks
-    std::vector<uint8_t> tx_block_bytes;
-    std::vector<uint8_t> rx_block_bytes;
-    std::vector<float> output_symbols_float;
-    std::vector<soft_t> output_symbols; 
-    std::vector<float> bit_error_rates;
-    vitdec.set_traceback_length(total_block_bits);
-    tx_block_bytes.resize(total_block_bytes);
-    rx_block_bytes.resize(total_block_bytes);
-    output_symbols_float.resize(total_block_symbols);
-    output_symbols.resize(total_block_symbols);
-    // determine offset and scale for normalised symbols
-    const float symbol_norm_mean = (float(soft_decision_high) + float(soft_decision_low)) / 2.0f;
-    const float symbol_norm_magnitude = (float(soft_decision_high) - float(soft_decision_low)) / 2.0f;
- 
-    TestResults results;
-    const size_t max_generated_bits = size_t(std::ceil(args.maximum_generated_bits_scale*float(test_range.maximum_generated_bits)));
-    // Move seed here to avoid infinite loop for high EbNo_dB
-    std::mt19937 rand_engine{(unsigned int)(args.random_seed)};
-    for (size_t curr_point = 0; ; curr_point++) {
-        const float EbNo_dB = test_range.EbNo_dB_initial + float(curr_point)*test_range.EbNo_dB_step;
-        const float EsNo_dB = EbNo_dB - 10.0f*std::log10(float(R));
-        // E(X^2) = Var(X) + [E(X)]^2 = Var(X), since E(X) = 0
-        const float noise_variance = std::pow(10.0f, -(EsNo_dB+3.0f)/10.0f); // 3dB for real signal
-        const float noisy_signal_energy = 1.0f + noise_variance;
-        const float noisy_signal_norm = 1.0f/std::sqrt(noisy_signal_energy);
-        std::normal_distribution<float> rand_norm_dist(0.0f, std::sqrt(noise_variance)); // takes sigma not sigma^2
-        std::uniform_int_distribution<int> rand_bytes_dist(0, 255);
-
-        const float noisy_symbol_combined_norm = symbol_norm_magnitude * noisy_signal_norm;
-
-        // measure performance
-        Timer total_time;
-        size_t total_bit_errors = 0;
-        size_t total_bits = 0;
-        bool is_timeout = false;
-        while (true) {
-            // generate data
-            for (size_t i = 0; i < total_block_bytes; i++) {
-                tx_block_bytes[i] = uint8_t(rand_bytes_dist(rand_engine));
+    issue_work_items<decoder_t>(sweep, args);
+}
+
+// Queues work items until every thread has one from this sweep
+// The earliest unresolved point is filled first and later points are started speculatively
+// NOTE: Caller must not hold the lock on the sweep
+template <class decoder_t, size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+void issue_work_items(const std::shared_ptr<SweepState<K,R,code_t,error_t,soft_t>>& sweep, const Arguments& args) {
+    std::vector<std::pair<size_t, size_t>> new_items;
+    {
+        auto lock = std::scoped_lock(sweep->mutex);
+        const size_t max_in_flight = thread_pool->get_total_threads();
+        while (sweep->total_in_flight < max_in_flight) {
+            // Find the earliest point with batches left to run
+            PointState* point = nullptr;
+            size_t point_index = 0;
+            for (; point_index < sweep->points.size(); point_index++) {
+                if (sweep->last_point.has_value() && point_index > sweep->last_point.value()) break;
+                auto& p = sweep->points[point_index];
+                if (p.is_resolved) continue;
+                if (p.total_issued_batches >= p.maximum_batches) continue;
+                point = &p;
+                break;
             }
-            enc->reset();
-            encode_data(
-                enc,
-                tx_block_bytes.data(), tx_block_bytes.size(), 
-                output_symbols_float.data(), output_symbols_float.size(),
-                1.0f, -1.0f
-            );
-            // add noise
-            for (float& v: output_symbols_float) {
-                v += rand_norm_dist(rand_engine);
+            if (point == nullptr) {
+                // Start the next point unless the sweep has already ended before it
+                const size_t next_index = sweep->points.size();
+                if (sweep->last_point.has_value()) break;
+                if (next_index > args.maximum_data_points) break;
+                sweep->points.push_back(create_point(next_index, K, R, args));
+                point_index = next_index;
+                point = &sweep->points.back();
             }
-            // convert to soft decision bits at receiver
-            for (size_t i = 0; i < total_block_symbols; i++) {
-                const float noisy_bit = output_symbols_float[i];
-                const float norm_bit = noisy_bit*noisy_symbol_combined_norm + symbol_norm_mean;
-                soft_t soft_bit = soft_t(std::round(norm_bit));
-                if (soft_bit > soft_decision_high) soft_bit = soft_decision_high;
-                if (soft_bit < soft_decision_low) soft_bit = soft_decision_low;
-                output_symbols[i] = soft_bit;
+            new_items.push_back({point_index, point->total_issued_batches});
+            point->total_issued_batches++;
+            if (point->batches.size() < point->total_issued_batches) {
+                point->batches.resize(point->total_issued_batches);
             }
-            // traceback
-            const size_t total_output_symbols = output_symbols.size();
-            vitdec.reset();
-            const uint64_t accumulated_error = decoder_t::template update<uint64_t>(
-                vitdec, output_symbols.data(), output_symbols.size());
-            const uint64_t block_error = accumulated_error + uint64_t(vitdec.get_error());
-            vitdec.chainback(rx_block_bytes.data(), total_block_bits, 0u);
-            const size_t block_bit_errors = get_total_bit_errors(tx_block_bytes.data(), rx_block_bytes.data(), total_block_bytes);
-            total_bit_errors += block_bit_errors;
-            total_bits += total_block_bits;
-            if (total_bits >= max_generated_bits) break;
-            if (total_bit_errors >= args.maximum_error_bits) break;
-            if (args.timeout_seconds.has_value()) {
-                const float time_elapsed_seconds = float(double(total_time.get_delta()) * 1e-9); 
+            sweep->total_in_flight++;
+        }
+    }
+    for (const auto& [point_index, batch_index]: new_items) {
+        thread_pool->push_task([sweep, args, point_index=point_index, batch_index=batch_index](size_t thread_id) {
+            run_work_item<decoder_t>(sweep, args, point_index, batch_index, thread_id);
+        });
+    }
+}
+
+template <class decoder_t, size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+void run_work_item(
+    const std::shared_ptr<SweepState<K,R,code_t,error_t,soft_t>>& sweep, const Arguments& args,
+    const size_t point_index, const size_t batch_index, const size_t thread_id
+) {
+    using Context = BlockContext<K,R,error_t,soft_t>;
+    std::unique_ptr<Context> ctx = nullptr;
+    float EbNo_dB = 0.0f;
+    bool is_skip = false;
+    {
+        auto lock = std::scoped_lock(sweep->mutex);
+        const auto& point = sweep->points[point_index];
+        EbNo_dB = point.EbNo_dB;
+        // Points after the end of the sweep and batches after a point has resolved aren't needed
+        is_skip = point.is_resolved || (sweep->last_point.has_value() && point_index > sweep->last_point.value());
+        if (!is_skip && !sweep->free_contexts.empty()) {
+            ctx = std::move(sweep->free_contexts.back());
+            sweep->free_contexts.pop_back();
+        }
+    }
+
+    BatchResult batch;
+    if (!is_skip) {
+        if (ctx == nullptr) {
+            ctx = std::make_unique<Context>(sweep->branch_table, sweep->config.decoder_config, sweep->code.G.data());
+            const size_t total_block_bytes = args.traceback_length_bytes;
+            const size_t total_block_symbols = (total_block_bytes*8u + K-1u) * R;
+            ctx->vitdec.set_traceback_length(total_block_bytes*8u);
+            ctx->tx_block_bytes.resize(total_block_bytes);
+            ctx->rx_block_bytes.resize(total_block_bytes);
+            ctx->output_symbols_float.resize(total_block_symbols);
+            ctx->output_symbols.resize(total_block_symbols);
+        }
+        const uint64_t seed = get_work_item_seed(args.random_seed, point_index, batch_index);
+        batch = run_batch<decoder_t>(
+            *ctx, sweep->config.soft_decision_high, sweep->config.soft_decision_low,
+            EbNo_dB, seed, args.blocks_per_work_item
+        );
+    }
+
+    bool is_finished = false;
+    {
+        auto lock = std::scoped_lock(sweep->mutex);
+        if (ctx != nullptr) {
+            sweep->free_contexts.push_back(std::move(ctx));
+        }
+        sweep->total_in_flight--;
+        auto& point = sweep->points[point_index];
+        if (!is_skip && !point.is_resolved) {
+            point.batches[batch_index] = batch;
+            // Merge batches in order until the stopping criteria are met
+            const size_t max_generated_bits = get_maximum_generated_bits(K, R, args);
+            const size_t prev_merged_batches = point.total_merged_batches;
+            while (point.total_merged_batches < point.total_issued_batches) {
+                const auto& next = point.batches[point.total_merged_batches];
+                if (!next.has_value()) break;
+                point.merged.total_bit_errors += next->total_bit_errors;
+                point.merged.total_squared_frame_bit_errors += next->total_squared_frame_bit_errors;
+                point.merged.total_bits += next->total_bits;
+                point.merged.total_frame_errors += next->total_frame_errors;
+                point.merged.total_frames += next->total_frames;
+                point.total_merged_batches++;
+                if (point.merged.total_bits >= max_generated_bits) point.is_resolved = true;
+                if (args.relative_precision.has_value()) {
+                    if (is_point_precise(point.merged, args)) point.is_resolved = true;
+                } else {
+                    if (point.merged.total_bit_errors >= args.maximum_error_bits) point.is_resolved = true;
+                }
+                if (point.total_merged_batches >= point.maximum_batches) point.is_resolved = true;
+                if (point.is_resolved) break;
+            }
+            if (!point.is_resolved && args.timeout_seconds.has_value() && point.total_merged_batches > 0) {
+                const float time_elapsed_seconds = float(double(point.timer->get_delta()) * 1e-9);
                 if (time_elapsed_seconds > args.timeout_seconds.value()) {
-                    is_timeout = true;
-                    break;
+                    point.is_resolved = true;
+                    point.is_timeout = true;
+                }
+            }
+            const uint64_t time_elapsed_ns = point.timer->get_delta();
+            const bool is_checkpoint_due =
+                (point.total_merged_batches > prev_merged_batches) &&
+                ((time_elapsed_ns - point.last_checkpoint_ns) >= CHECKPOINT_INTERVAL_NS);
+            if (point.is_resolved || is_checkpoint_due) {
+                point.last_checkpoint_ns = time_elapsed_ns;
+                write_checkpoint_point(*sweep, point_index);
+            }
+            if (point.is_resolved) {
+                point.batches.clear();
+                const auto ber = get_ber_interval(point.merged, args);
+                const auto fer = get_fer_interval(point.merged, args);
+                {
+                    auto lock_stderr = std::scoped_lock(mutex_stderr);
+                    fprintf(stderr,
+                        "thread=%zu,name='%s',K=%zu,R=%zu,decode=%s,simd=%s,iter=%zu,EbNo_dB=%.1f,"
+                        "BER=%.3e[%.3e,%.3e],FER=%.3e[%.3e,%.3e],bits=%zu,timeout=%u\n",
+                        thread_id,
+                        sweep->code.name, sweep->code.K, sweep->code.R,
+                        get_decode_type_str(sweep->decode_type), get_simd_type_string(sweep->simd_type),
+                        point_index, point.EbNo_dB,
+                        ber.estimate, ber.lower, ber.upper,
+                        fer.estimate, fer.lower, fer.upper,
+                        point.merged.total_bits, point.is_timeout
+                    );
+                }
+                if (is_last_point(point, point_index, args)) {
+                    const size_t last_point = sweep->last_point.value_or(point_index);
+                    sweep->last_point = min(last_point, point_index);
                 }
             }
         }
-        const float bit_error_rate = float(total_bit_errors) / float(total_bits);
-
-        results.EbNo_dB.push_back(EbNo_dB);
-        results.bit_error_rates.push_back(bit_error_rate);
-        results.total_bit_errors.push_back(total_bit_errors);
-        results.total_bits.push_back(total_bits);
-
-        auto lock_stderr = std::scoped_lock(mutex_stderr);
-        fprintf(stderr, "thread=%zu,name='%s',K=%zu,R=%zu,decode=%s,simd=%s,iter=%zu,EbNo_dB=%.1f,BER=%.3e,timeout=%u\n", 
-            thread_id,
-            code.name, code.K, code.R, 
-            get_decode_type_str(decode_type), get_simd_type_string(simd_type),
-            curr_point, EbNo_dB, bit_error_rate, is_timeout
+        is_finished = print_resolved_points(*sweep, args);
+    }
+
+    if (is_finished) return;
+    issue_work_items<decoder_t>(sweep, args);
+}
+
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+BatchResult run_batch(
+    BlockContext<K,R,error_t,soft_t>& ctx,
+    const soft_t soft_decision_high, const soft_t soft_decision_low,
+    const float EbNo_dB, const uint64_t seed, const size_t total_blocks
+) {
+    const size_t total_block_bytes = ctx.tx_block_bytes.size();
+    const size_t total_block_bits = total_block_bytes*8u;
+    const size_t total_block_symbols = ctx.output_symbols.size();
+
+    auto noise_gen = NormalGenerator(seed);
+    const auto channel = AWGN_Channel<soft_t>(EbNo_dB, R, soft_decision_high, soft_decision_low);
+
+    BatchResult result;
+    for (size_t block = 0; block < total_blocks; block++) {
+        // generate data
+        noise_gen.get_rng().fill_bytes(ctx.tx_block_bytes.data(), total_block_bytes);
+        ctx.enc.reset();
+        encode_data(
+            ctx.enc,
+            ctx.tx_block_bytes.data(), ctx.tx_block_bytes.size(),
+            ctx.output_symbols_float.data(), ctx.output_symbols_float.size(),
+            1.0f, -1.0f
         );
-        if (total_bit_errors == 0) break;
-        if (curr_point >= args.maximum_data_points) break;
-        if (is_timeout) break;
+        // add noise and convert to soft decision bits at receiver
+        channel.transmit(ctx.output_symbols_float.data(), ctx.output_symbols.data(), total_block_symbols, noise_gen);
+        // traceback
+        ctx.vitdec.reset();
+        decoder_t::template update<uint64_t>(ctx.vitdec, ctx.output_symbols.data(), ctx.output_symbols.size());
+        ctx.vitdec.chainback(ctx.rx_block_bytes.data(), total_block_bits, 0u);
+        const size_t total_bit_errors = get_total_bit_errors(ctx.tx_block_bytes.data(), ctx.rx_block_bytes.data(), total_block_bytes);
+        result.total_bit_errors += total_bit_errors;
+        result.total_squared_frame_bit_errors += uint64_t(total_bit_errors)*uint64_t(total_bit_errors);
+        result.total_bits += total_block_bits;
+        result.total_frame_errors += (total_bit_errors > 0) ? 1 : 0;
+        result.total_frames++;
     }
+    return result;
+}
+
+template <size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+size_t restore_points(SweepState<K,R,code_t,error_t,soft_t>& sweep, const Arguments& args) {
+    const std::string name = sweep.code.name;
+    const std::string decode_type = get_decode_type_str(sweep.decode_type);
+    const std::string simd_type = get_simd_type_string(sweep.simd_type);
+    std::optional<size_t> max_point_index = std::nullopt;
+    for (const auto& [key, saved]: g_checkpoint_points) {
+        if (std::get<0>(key) != name || std::get<1>(key) != decode_type || std::get<2>(key) != simd_type) continue;
+        max_point_index = max(max_point_index.value_or(0), std::get<3>(key));
+    }
+    if (!max_point_index.has_value()) return 0;
+
+    size_t total_restored = 0;
+    for (size_t point_index = 0; point_index <= max_point_index.value(); point_index++) {
+        if (sweep.last_point.has_value()) break;
+        if (point_index > args.maximum_data_points) break;
+        auto point = create_point(point_index, K, R, args);
+        const auto it = g_checkpoint_points.find(CheckpointKey{name, decode_type, simd_type, point_index});
+        // Skip points from a run with a different Eb/No range
+        if (it != g_checkpoint_points.end() && std::abs(it->second.EbNo_dB - point.EbNo_dB) < 1e-3f) {
+            const auto& saved = it->second;
+            point.total_merged_batches = saved.total_merged_batches;
+            point.total_issued_batches = saved.total_merged_batches;
+            point.batches.resize(saved.total_merged_batches);
+            point.merged = saved.merged;
+            point.is_resolved = saved.is_resolved;
+            point.is_timeout = saved.is_timeout;
+            if (point.is_resolved) point.batches.clear();
+            total_restored++;
+        }
+        sweep.points.push_back(std::move(point));
+        const auto& p = sweep.points.back();
+        if (p.is_resolved && is_last_point(p, point_index, args)) {
+            sweep.last_point = point_index;
+        }
+    }
+    return total_restored;
+}
+
+// NOTE: Caller must hold the lock on the sweep
+template <size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+void write_checkpoint_point(const SweepState<K,R,code_t,error_t,soft_t>& sweep, const size_t point_index) {
+    if (fp_checkpoint == nullptr) return;
+    const auto& point = sweep.points[point_index];
+    const auto& merged = point.merged;
+    auto lock = std::scoped_lock(mutex_fp_checkpoint);
+    fprintf(fp_checkpoint,
+        "{\"type\": \"point\", \"name\": \"%s\", \"decode_type\": \"%s\", \"simd_type\": \"%s\", "
+        "\"point_index\": %zu, \"EbNo_dB\": %.1f, \"total_merged_batches\": %zu, "
+        "\"total_bit_errors\": %zu, \"total_squared_frame_bit_errors\": %" PRIu64 ", "
+        "\"total_bits\": %zu, \"total_frame_errors\": %zu, \"total_frames\": %zu, "
+        "\"is_resolved\": %s, \"is_timeout\": %s}\n",
+        sweep.code.name, get_decode_type_str(sweep.decode_type), get_simd_type_string(sweep.simd_type),
+        point_index, point.EbNo_dB, point.total_merged_batches,
+        merged.total_bit_errors, merged.total_squared_frame_bit_errors,
+        merged.total_bits, merged.total_frame_errors, merged.total_frames,
+        point.is_resolved ? "true" : "false", point.is_timeout ? "true" : "false"
+    );
+    fflush(fp_checkpoint);
+}
 
-    return results;
+// Prints every newly resolved point whose earlier points have all been printed
+// This keeps the output in Eb/No order and independent of the number of threads
+// Returns true once the whole sweep has been printed
+// NOTE: Caller must hold the lock on the sweep
+template <size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+bool print_resolved_points(SweepState<K,R,code_t,error_t,soft_t>& sweep, const Arguments& args) {
+    if (sweep.is_printed) return false;
+    while (sweep.total_printed_points < sweep.points.size()) {
+        const size_t point_index = sweep.total_printed_points;
+        if (sweep.last_point.has_value() && point_index > sweep.last_point.value()) break;
+        if (!sweep.points[point_index].is_resolved) break;
+        {
+            auto lock_fp_out = std::scoped_lock(mutex_fp_out);
+            print_point_result(fp_out, sweep, point_index, args);
+        }
+        sweep.total_printed_points++;
+    }
+    // Sweep is done once every point up to the last has been printed
+    if (!sweep.last_point.has_value()) return false;
+    if (sweep.total_printed_points <= sweep.last_point.value()) return false;
+    sweep.is_printed = true;
+    sweep.free_contexts.clear();
+    return true;
 }
 
 template <typename T>
@@ -405,37 +973,43 @@ void fprintf_list(FILE* fp_out, const char* formatter, tcb::span<const T> list)
     const size_t N = list.size();
     for (size_t i = 0; i < N; i++) {
         fprintf(fp_out, formatter, list[i]);
-        if (i < (N-1)) printf(",");
+        if (i < (N-1)) fprintf(fp_out, ",");
     }
     fprintf(fp_out, "]");
 }
 
-template <size_t K, size_t R, typename code_t>
-void print_test_results(
-    FILE* fp_out, 
-    const Code<K,R,code_t>& code, 
-    const DecodeType decode_type, const SIMD_Type simd_type,
-    const TestResults& results
-) {
-    if (!g_is_first_result) {
-        fprintf(fp_out, ",\n");
-    } else {
-        g_is_first_result = false;
-    }
-    fprintf(fp_out, "{\n");
-    fprintf(fp_out, " \"name\": \"%s\",\n", code.name);
-    fprintf(fp_out, " \"decode_type\": \"%s\",\n", get_decode_type_str(decode_type));
-    fprintf(fp_out, " \"simd_type\": \"%s\",\n", get_simd_type_string(simd_type));
-    fprintf(fp_out, " \"K\": %zu,\n", code.K);
-    fprintf(fp_out, " \"R\": %zu,\n", code.R);
-    fprintf(fp_out, " \"G\": ");
-    fprintf_list(fp_out, "%u", tcb::span<const code_t>(code.G));
-    fprintf(fp_out, ",\n");
-    fprintf(fp_out, " \"EbNo_dB\": ");
-    fprintf_list(fp_out, "%.1f", tcb::span<const float>(results.EbNo_dB));
-    fprintf(fp_out, ",\n");
-    fprintf(fp_out, " \"ber\": ");
-    fprintf_list(fp_out, "%.3e", tcb::span<const float>(results.bit_error_rates));
-    fprintf(fp_out, "\n");
-    fprintf(fp_out, "}");
+void fprintf_interval(FILE* fp_out, const char* key, const ProportionInterval& interval) {
+    fprintf(fp_out, "\"%s\": %.3e, \"%s_lower\": %.3e, \"%s_upper\": %.3e",
+        key, interval.estimate, key, interval.lower, key, interval.upper);
+}
+
+template <size_t K, size_t R, typename code_t, typename error_t, typename soft_t>
+void print_point_result(FILE* fp_out, const SweepState<K,R,code_t,error_t,soft_t>& sweep, const size_t point_index, const Arguments& args) {
+    const auto& point = sweep.points[point_index];
+    const auto& merged = point.merged;
+    const auto ber = get_ber_interval(merged, args);
+    const auto fer = get_fer_interval(merged, args);
+    fprintf(fp_out, "{");
+    fprintf(fp_out, "\"name\": \"%s\", ", sweep.code.name);
+    fprintf(fp_out, "\"decode_type\": \"%s\", ", get_decode_type_str(sweep.decode_type));
+    fprintf(fp_out, "\"simd_type\": \"%s\", ", get_simd_type_string(sweep.simd_type));
+    fprintf(fp_out, "\"K\": %zu, ", sweep.code.K);
+    fprintf(fp_out, "\"R\": %zu, ", sweep.code.R);
+    fprintf(fp_out, "\"G\": ");
+    fprintf_list(fp_out, "%u", tcb::span<const code_t>(sweep.code.G));
+    fprintf(fp_out, ", ");
+    fprintf(fp_out, "\"point_index\": %zu, ", point_index);
+    fprintf(fp_out, "\"EbNo_dB\": %.1f, ", point.EbNo_dB);
+    fprintf(fp_out, "\"confidence_level\": %.3f, ", args.confidence_level);
+    fprintf_interval(fp_out, "ber", ber);
+    fprintf(fp_out, ", ");
+    fprintf_interval(fp_out, "fer", fer);
+    fprintf(fp_out, ", ");
+    fprintf(fp_out, "\"total_bit_errors\": %zu, ", merged.total_bit_errors);
+    fprintf(fp_out, "\"total_bits\": %zu, ", merged.total_bits);
+    fprintf(fp_out, "\"total_frame_errors\": %zu, ", merged.total_frame_errors);
+    fprintf(fp_out, "\"total_frames\": %zu, ", merged.total_frames);
+    fprintf(fp_out, "\"timeout\": %s", point.is_timeout ? "true" : "false");
+    fprintf(fp_out, "}\n");
+    fflush(fp_out);
 }
@@ -7,10 +7,22 @@
 #include <vector>
 #include <map>
 #include <random>
+#include <limits>
 
 #include "viterbi/convolutional_encoder.h"
 #include "viterbi/convolutional_encoder_shift_register.h"
+#include "viterbi/convolutional_encoder_templated.h"
+#include "viterbi/convolutional_encoder_split_lookup.h"
+#include "viterbi/convolutional_encoder_bitsliced.h"
 #include "viterbi/viterbi_decoder_core.h"
+#include "viterbi/viterbi_decoder_observer.h"
+#include "arch/simd_flags.h"
+#if defined(__PCLMUL__)
+#include "viterbi/x86/convolutional_encoder_pclmul.h"
+#endif
+#if defined(__SIMD_PMULL__)
+#include "viterbi/arm/convolutional_encoder_pmull.h"
+#endif
 
 #include "helpers/common_codes.h"
 #include "helpers/simd_type.h"
@@ -60,13 +72,137 @@ public:
     }
 };
 
-std::map<TestKey, const char*> SKIP_TESTS = {
-    { TestKey(SIMD_Type::SCALAR, DecodeType::SOFT8, 15, 6), "Overflow in metrics due to high code rate and non saturating arithmetic" },
-};
+std::map<TestKey, const char*> SKIP_TESTS = {};
 
 template <class factory_t, typename ... U>
 void select_codes(U&& ... args);
 
+// Passes the decoder type to a generic lambda
+template <class T>
+struct TypeTag {
+    using type = T;
+};
+
+// Random input bytes encoded with tail bits that terminate the trellis at state 0
+template <typename soft_t>
+struct TestFrame {
+    size_t total_input_bits = 0;
+    size_t total_bits = 0;
+    std::vector<uint8_t> tx_input_bytes;
+    std::vector<soft_t> symbols;
+};
+
+template <size_t K, size_t R, typename soft_t>
+TestFrame<soft_t> make_noisy_frame(
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low,
+    const uint64_t noise_level
+);
+
+template <class factory_t, size_t K, size_t R, typename code_t, typename F>
+void for_each_decoder(
+    const Code<K,R,code_t>& code, GlobalTestResults& global_results, const DecodeType decode_type,
+    const char* category, const char* failure_message, F&& run_test
+);
+
+template <size_t K, size_t R, typename code_t>
+bool run_encoder_test(const Code<K,R,code_t>& code, const size_t total_input_bytes, const size_t total_split_bytes);
+
+template <size_t K, size_t R, typename code_t>
+bool run_block_encoder_test(
+    ConvolutionalEncoder* enc, const Code<K,R,code_t>& code, 
+    const size_t total_input_bytes, const size_t total_split_bytes);
+
+template <size_t total_lanes, size_t K, size_t R, typename code_t>
+bool run_bitsliced_encoder_test(const Code<K,R,code_t>& code, const size_t total_input_bytes, const size_t total_split_bytes);
+
+template <size_t K, size_t R, typename code_t>
+void run_encoder_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes);
+
+template <size_t K, size_t R, typename code_t>
+void run_observer_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes);
+
+template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void run_observer_tests_for(
+    const Code<K,R,code_t>& code, const Decoder_Config<soft_t,error_t>& config,
+    const DecodeType decode_type, const char* category,
+    const uint64_t noise_level, const bool is_saturating,
+    GlobalTestResults& global_results, const size_t total_input_bytes
+);
+
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+bool run_observer_test(
+    ViterbiDecoder_Core<K,R,error_t,soft_t,ViterbiDecoder_HealthObserver>& vitdec,
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low,
+    const uint64_t noise_level,
+    const bool is_saturating
+);
+
+template <size_t K, size_t R, typename code_t>
+void run_reliability_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes);
+
+template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void run_reliability_tests_for(
+    const Code<K,R,code_t>& code, const Decoder_Config<soft_t,error_t>& config,
+    const DecodeType decode_type, const char* category,
+    GlobalTestResults& global_results, const size_t total_input_bytes
+);
+
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+bool run_reliability_test(
+    ViterbiDecoder_Core<K,R,error_t,soft_t>& vitdec,
+    ViterbiDecoder_Core<K,R,error_t,soft_t>& ref_vitdec,
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low
+);
+
+template <size_t K, size_t R, typename code_t>
+void run_push_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes);
+
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+bool run_push_test(
+    ViterbiDecoder_Core<K,R,error_t,soft_t>& vitdec,
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low
+);
+
+template <size_t K, size_t R, typename code_t>
+void run_fork_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes);
+
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+bool run_fork_test(
+    const ViterbiBranchTable<K,R,soft_t>& branch_table,
+    const ViterbiDecoder_Config<error_t>& decoder_config,
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low
+);
+
+template <size_t K, size_t R, typename code_t>
+void run_pruned_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes);
+
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+bool run_pruned_test(
+    const ViterbiBranchTable<K,R,soft_t>& branch_table,
+    const ViterbiDecoder_Config<error_t>& decoder_config,
+    const ViterbiDecoder_Config<error_t>& ref_decoder_config,
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low,
+    const bool is_noisy
+);
+
 template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
 void run_tests(
     const Code<K,R,code_t>& code, 
@@ -79,7 +215,7 @@ void run_tests(
 template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
 TestResult run_test(
     ViterbiDecoder_Core<K,R,error_t,soft_t>& vitdec, 
-    ConvolutionalEncoder* enc, 
+    ConvolutionalEncoderT<K,R>& enc, 
     const size_t total_input_bytes,
     const soft_t soft_decision_high,
     const soft_t soft_decision_low
@@ -93,7 +229,7 @@ void print_code(const Code<K,R,code_t>& code);
 template <size_t K, size_t R, typename code_t>
 void print_skip_message(
     const Code<K,R,code_t>& code, 
-    const DecodeType decode_type,
+    const char* category,
     const SIMD_Type simd_type,
     const char* message
 );
@@ -106,6 +242,12 @@ void print_test_result(
     const SIMD_Type simd_type
 );
 
+template <size_t K, size_t R, typename code_t>
+void print_named_test_result(
+    const bool is_pass, const Code<K,R,code_t>& code, 
+    const char* category, const char* name, const char* failure_message
+);
+
 void print_summary(const GlobalTestResults& results);
 
 void usage() {
@@ -130,6 +272,25 @@ int main(int argc, char** argv) {
     GlobalTestResults global_results;
 
     print_header();
+    FOR_COMMON_CODES({
+        run_encoder_tests(it, global_results, total_input_bytes);
+    });
+    FOR_COMMON_CODES({
+        run_observer_tests(it, global_results, total_input_bytes);
+    });
+    FOR_COMMON_CODES({
+        run_reliability_tests(it, global_results, total_input_bytes);
+    });
+    FOR_COMMON_CODES({
+        run_push_tests(it, global_results, total_input_bytes);
+    });
+    FOR_COMMON_CODES({
+        run_fork_tests(it, global_results, total_input_bytes);
+    });
+    FOR_COMMON_CODES({
+        run_pruned_tests(it, global_results, total_input_bytes);
+    });
+
     for (const auto& decode_type: Decode_Type_List) {
         SELECT_DECODE_TYPE(decode_type, {
             auto config = it0;
@@ -150,6 +311,565 @@ void select_codes(U&& ... args) {
     });
 }
 
+template <size_t total_lanes, size_t K, size_t R, typename code_t>
+bool run_bitsliced_encoder_test(const Code<K,R,code_t>& code, const size_t total_input_bytes, const size_t total_split_bytes);
+
+template <size_t K, size_t R, typename code_t>
+void run_encoder_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes) {
+    auto push_result = [&](const bool is_pass, const char* name) {
+        print_named_test_result(
+            is_pass, code, "Encoder", name, 
+            "Encoded output does not match reference shift register encoder.");
+        global_results.total_tests++;
+        if (is_pass) {
+            global_results.total_pass++;
+        }
+    };
+
+    // Compare against reference encoder over partial words and split blocks
+    {
+        const bool is_pass = 
+            run_encoder_test(code, 1, 0) && 
+            run_encoder_test(code, 7, 3) &&
+            run_encoder_test(code, total_input_bytes+3, 8) && 
+            run_encoder_test(code, total_input_bytes+3, 13);
+        push_result(is_pass, "Templated");
+    }
+
+    {
+        const bool is_pass = 
+            run_bitsliced_encoder_test<1>(code, 1, 0) && 
+            run_bitsliced_encoder_test<1>(code, total_input_bytes, 5) && 
+            run_bitsliced_encoder_test<4>(code, 7, 3);
+        push_result(is_pass, "Bitsliced");
+    }
+
+    auto run_block_tests = [&](ConvolutionalEncoder* enc) {
+        return 
+            run_block_encoder_test(enc, code, 1, 0) && 
+            run_block_encoder_test(enc, code, 7, 3) &&
+            run_block_encoder_test(enc, code, total_input_bytes+3, 8) && 
+            run_block_encoder_test(enc, code, total_input_bytes+3, 13);
+    };
+    {
+        auto enc = ConvolutionalEncoder_SplitLookup(code.K, code.R, code.G.data());
+        push_result(run_block_tests(&enc), "Split LUT");
+    }
+    #if defined(__PCLMUL__)
+    {
+        auto enc = ConvolutionalEncoder_PCLMUL(code.K, code.R, code.G.data());
+        push_result(run_block_tests(&enc), "PCLMUL");
+    }
+    #endif
+    #if defined(__SIMD_PMULL__)
+    {
+        auto enc = ConvolutionalEncoder_PMULL(code.K, code.R, code.G.data());
+        push_result(run_block_tests(&enc), "PMULL");
+    }
+    #endif
+}
+
+// Adds uniform noise below noise_level to each symbol and clamps it to the soft decision range
+template <size_t K, size_t R, typename soft_t>
+TestFrame<soft_t> make_noisy_frame(
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low,
+    const uint64_t noise_level
+) {
+    TestFrame<soft_t> frame;
+    frame.total_input_bits = total_input_bytes*8u;
+    frame.total_bits = frame.total_input_bits + K-1u;
+    frame.tx_input_bytes.resize(total_input_bytes);
+    frame.symbols.resize(frame.total_bits*R);
+
+    generate_random_bytes(frame.tx_input_bytes.data(), frame.tx_input_bytes.size());
+    enc.reset();
+    encode_data(
+        enc, 
+        frame.tx_input_bytes.data(), frame.tx_input_bytes.size(), 
+        frame.symbols.data(), frame.symbols.size(),
+        soft_decision_high, soft_decision_low
+    );
+    if (noise_level > 0u) {
+        add_noise(frame.symbols.data(), frame.symbols.size(), noise_level);
+        clamp_vector(frame.symbols.data(), frame.symbols.size(), soft_decision_low, soft_decision_high);
+    }
+    return frame;
+}
+
+// Calls run_test(TypeTag<decoder_t>{}) for each decoder of the factory that supports the code and prints its result
+// Decoders listed in SKIP_TESTS for the decode type are skipped
+template <class factory_t, size_t K, size_t R, typename code_t, typename F>
+void for_each_decoder(
+    const Code<K,R,code_t>& code, GlobalTestResults& global_results, const DecodeType decode_type,
+    const char* category, const char* failure_message, F&& run_test
+) {
+    for (const auto& simd_type: SIMD_Type_List) {
+        SELECT_FACTORY_ITEM(factory_t, simd_type, K, R, {
+            using decoder_t = it;
+            if constexpr(decoder_t::is_valid) {
+                const auto& skip_entry = SKIP_TESTS.find(TestKey(simd_type, decode_type, K, R));
+                if (skip_entry != SKIP_TESTS.end()) {
+                    print_skip_message(code, category, simd_type, skip_entry->second);
+                    global_results.total_skipped++;
+                } else {
+                    const bool is_pass = run_test(TypeTag<decoder_t>{});
+                    print_named_test_result(is_pass, code, category, get_simd_type_string(simd_type), failure_message);
+                    global_results.total_tests++;
+                    if (is_pass) {
+                        global_results.total_pass++;
+                    }
+                }
+            }
+        });
+    }
+}
+
+template <size_t K, size_t R, typename code_t>
+void run_observer_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes) {
+    {
+        // Lower renormalisation threshold so it is triggered within a short test
+        auto config = get_soft16_decoding_config(code.R);
+        auto& decoder_config = config.decoder_config;
+        decoder_config.renormalisation_threshold = decoder_config.initial_non_start_error + decoder_config.soft_decision_max_error*4u;
+        run_observer_tests_for<ViterbiDecoder_ObservedFactory_u16<ViterbiDecoder_HealthObserver>>(
+            code, config, DecodeType::SOFT16, "Observer", 32u, false,
+            global_results, total_input_bytes);
+    }
+    {
+        // Renormalise only once the first metric is at the maximum so the rest of the metrics saturate before then
+        auto config = get_soft8_decoding_config(code.R);
+        config.decoder_config.renormalisation_threshold = std::numeric_limits<uint8_t>::max();
+        run_observer_tests_for<ViterbiDecoder_ObservedFactory_u8<ViterbiDecoder_HealthObserver>>(
+            code, config, DecodeType::SOFT8, "Saturate", uint64_t(config.soft_decision_high-config.soft_decision_low), true,
+            global_results, total_input_bytes);
+    }
+}
+
+template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void run_observer_tests_for(
+    const Code<K,R,code_t>& code, const Decoder_Config<soft_t,error_t>& config,
+    const DecodeType decode_type, const char* category,
+    const uint64_t noise_level, const bool is_saturating,
+    GlobalTestResults& global_results, const size_t total_input_bytes
+) {
+    auto enc = ConvolutionalEncoderT<K,R>(code.G.data());
+    auto branch_table = ViterbiBranchTable<K,R,soft_t>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
+    auto vitdec = ViterbiDecoder_Core<K,R,error_t,soft_t,ViterbiDecoder_HealthObserver>(branch_table, config.decoder_config);
+
+    for_each_decoder<factory_t>(
+        code, global_results, decode_type, category, 
+        "Health observer counters do not match the decode run.",
+        [&](auto tag) {
+            using decoder_t = typename decltype(tag)::type;
+            return run_observer_test<decoder_t>(
+                vitdec, enc,
+                total_input_bytes,
+                config.soft_decision_high, config.soft_decision_low,
+                noise_level, is_saturating
+            );
+        }
+    );
+}
+
+// If is_saturating is set the metrics are expected to saturate and the decoded bits aren't checked
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+bool run_observer_test(
+    ViterbiDecoder_Core<K,R,error_t,soft_t,ViterbiDecoder_HealthObserver>& vitdec,
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low,
+    const uint64_t noise_level,
+    const bool is_saturating
+) {
+    // Noise keeps the minimum error metric growing so renormalisation has something to subtract
+    const auto frame = make_noisy_frame(enc, total_input_bytes, soft_decision_high, soft_decision_low, noise_level);
+    std::vector<uint8_t> rx_input_bytes;
+    rx_input_bytes.resize(total_input_bytes);
+    vitdec.set_traceback_length(frame.total_input_bits);
+
+    auto& observer = vitdec.m_observer;
+    observer.clear();
+    vitdec.reset();
+    const uint64_t accumulated_error = decoder_t::template update<uint64_t>(vitdec, frame.symbols.data(), frame.symbols.size());
+    vitdec.chainback(rx_input_bytes.data(), frame.total_input_bits, 0u);
+
+    const size_t total_errors = get_total_bit_errors(frame.tx_input_bytes.data(), rx_input_bytes.data(), total_input_bytes);
+    const bool is_saturation_correct = is_saturating ? 
+        (observer.total_saturated_metrics > 0) : 
+        ((total_errors == 0) && (observer.total_saturated_stages == 0));
+    return 
+        is_saturation_correct &&
+        (observer.total_resets == 1) &&
+        (observer.total_stages == uint64_t(frame.total_bits)) &&
+        (observer.total_renormalisations > 0) &&
+        (observer.total_renormalisation_error == accumulated_error) &&
+        (observer.total_chainbacks == 1) &&
+        (observer.total_chainback_bits == uint64_t(frame.total_input_bits));
+}
+
+// The 8bit decoders are checked as well since they have their own reliability paths
+template <size_t K, size_t R, typename code_t>
+void run_reliability_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes) {
+    run_reliability_tests_for<ViterbiDecoder_Factory_u16>(
+        code, get_soft16_decoding_config(code.R), DecodeType::SOFT16, "Reliab16", 
+        global_results, total_input_bytes);
+    run_reliability_tests_for<ViterbiDecoder_Factory_u8>(
+        code, get_soft8_decoding_config(code.R), DecodeType::SOFT8, "Reliab8", 
+        global_results, total_input_bytes);
+}
+
+template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
+void run_reliability_tests_for(
+    const Code<K,R,code_t>& code, const Decoder_Config<soft_t,error_t>& config,
+    const DecodeType decode_type, const char* category,
+    GlobalTestResults& global_results, const size_t total_input_bytes
+) {
+    const size_t total_tracked_stages = 32u;
+    const error_t margin_threshold = config.decoder_config.soft_decision_max_error;
+
+    auto enc = ConvolutionalEncoderT<K,R>(code.G.data());
+    auto branch_table = ViterbiBranchTable<K,R,soft_t>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
+    auto vitdec = ViterbiDecoder_Core<K,R,error_t,soft_t>(branch_table, config.decoder_config);
+    auto ref_vitdec = ViterbiDecoder_Core<K,R,error_t,soft_t>(branch_table, config.decoder_config);
+    vitdec.set_reliability_length(total_tracked_stages, margin_threshold);
+    ref_vitdec.set_reliability_length(total_tracked_stages, margin_threshold);
+
+    for_each_decoder<factory_t>(
+        code, global_results, decode_type, category, 
+        "Reliability does not match the scalar decoder or a clean frame was flagged.",
+        [&](auto tag) {
+            using decoder_t = typename decltype(tag)::type;
+            return run_reliability_test<decoder_t>(
+                vitdec, ref_vitdec, enc,
+                total_input_bytes,
+                config.soft_decision_high, config.soft_decision_low
+            );
+        }
+    );
+}
+
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+bool run_reliability_test(
+    ViterbiDecoder_Core<K,R,error_t,soft_t>& vitdec,
+    ViterbiDecoder_Core<K,R,error_t,soft_t>& ref_vitdec,
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low
+) {
+    using ref_decoder_t = ViterbiDecoder_Scalar<K,R,error_t,soft_t>;
+    auto frame = make_noisy_frame(enc, total_input_bytes, soft_decision_high, soft_decision_low, 0u);
+    auto& output_symbols = frame.symbols;
+    vitdec.set_traceback_length(frame.total_input_bits);
+    ref_vitdec.set_traceback_length(frame.total_input_bits);
+
+    // Every merge along the path of a clean frame is separated by at least the free distance of the code
+    vitdec.reset();
+    decoder_t::template update<uint64_t>(vitdec, output_symbols.data(), output_symbols.size());
+    const auto clean = vitdec.get_reliability(0u);
+    const size_t total_tracked_stages = vitdec.get_reliability_length();
+    const size_t total_expected_stages = min(frame.total_bits, total_tracked_stages);
+    if (clean.is_ambiguous()) return false;
+    if (clean.best_state != 0u) return false;
+    if (clean.get_margin() == 0u) return false;
+    if (clean.total_checked_stages != total_expected_stages) return false;
+
+    // Vectorised decoders should flag the same merges as the scalar decoder on a noisy frame
+    add_noise(output_symbols.data(), output_symbols.size(), uint64_t(soft_decision_high-soft_decision_low));
+    clamp_vector(output_symbols.data(), output_symbols.size(), soft_decision_low, soft_decision_high);
+    vitdec.reset();
+    ref_vitdec.reset();
+    decoder_t::template update<uint64_t>(vitdec, output_symbols.data(), output_symbols.size());
+    ref_decoder_t::template update<uint64_t>(ref_vitdec, output_symbols.data(), output_symbols.size());
+    const auto noisy = vitdec.get_reliability(0u);
+    const auto ref = ref_vitdec.get_reliability(0u);
+    return 
+        (noisy.best_state == ref.best_state) &&
+        (noisy.best_error == ref.best_error) &&
+        (noisy.second_best_error == ref.second_best_error) &&
+        (noisy.total_checked_stages == ref.total_checked_stages) &&
+        (noisy.total_ambiguous_stages == ref.total_ambiguous_stages);
+}
+
+template <size_t K, size_t R, typename code_t>
+void run_push_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes) {
+    using factory_t = ViterbiDecoder_Factory_u16;
+    const auto config = get_soft16_decoding_config(code.R);
+    auto enc = ConvolutionalEncoderT<K,R>(code.G.data());
+    auto branch_table = ViterbiBranchTable<K,R,int16_t>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
+    auto vitdec = ViterbiDecoder_Core<K,R,uint16_t,int16_t>(branch_table, config.decoder_config);
+
+    for_each_decoder<factory_t>(
+        code, global_results, DecodeType::SOFT16, "Push", 
+        "Pushing symbols in pieces does not match a single update.",
+        [&](auto tag) {
+            using decoder_t = typename decltype(tag)::type;
+            return run_push_test<decoder_t>(
+                vitdec, enc,
+                total_input_bytes,
+                config.soft_decision_high, config.soft_decision_low
+            );
+        }
+    );
+}
+
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+bool run_push_test(
+    ViterbiDecoder_Core<K,R,error_t,soft_t>& vitdec,
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low
+) {
+    const auto frame = make_noisy_frame(
+        enc, total_input_bytes, soft_decision_high, soft_decision_low, 
+        uint64_t(soft_decision_high-soft_decision_low)/2u);
+    const auto& output_symbols = frame.symbols;
+    const size_t total_input_bits = frame.total_input_bits;
+    const size_t total_symbols = output_symbols.size();
+    vitdec.set_traceback_length(total_input_bits);
+
+    std::vector<uint8_t> expected_bytes;
+    std::vector<uint8_t> rx_input_bytes;
+    expected_bytes.resize(total_input_bytes);
+    rx_input_bytes.resize(total_input_bytes);
+
+    vitdec.reset();
+    uint64_t expected_error = decoder_t::template update<uint64_t>(vitdec, output_symbols.data(), output_symbols.size());
+    expected_error += uint64_t(vitdec.get_error());
+    vitdec.chainback(expected_bytes.data(), total_input_bits, 0u);
+
+    // Piece sizes that are shorter, equal and longer than a stage
+    vitdec.reset();
+    uint64_t error = 0u;
+    size_t curr_symbol = 0u;
+    for (size_t i = 0u; curr_symbol < total_symbols; i++) {
+        const size_t total_piece = min((i*7u) % (3u*R+2u), total_symbols-curr_symbol);
+        error += vitdec.template push_symbols<decoder_t, uint64_t>(&output_symbols[curr_symbol], total_piece);
+        curr_symbol += total_piece;
+    }
+    error += uint64_t(vitdec.get_error());
+    if (vitdec.get_total_pending_symbols() != 0u) return false;
+    vitdec.chainback(rx_input_bytes.data(), total_input_bits, 0u);
+
+    return 
+        (error == expected_error) && 
+        (memcmp(expected_bytes.data(), rx_input_bytes.data(), total_input_bytes) == 0);
+}
+
+template <size_t K, size_t R, typename code_t>
+void run_fork_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes) {
+    using factory_t = ViterbiDecoder_Factory_u16;
+    const auto config = get_soft16_decoding_config(code.R);
+    auto enc = ConvolutionalEncoderT<K,R>(code.G.data());
+    auto branch_table = ViterbiBranchTable<K,R,int16_t>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
+
+    for_each_decoder<factory_t>(
+        code, global_results, DecodeType::SOFT16, "Fork", 
+        "Restored or forked decoder does not match an uninterrupted decode.",
+        [&](auto tag) {
+            using decoder_t = typename decltype(tag)::type;
+            return run_fork_test<decoder_t>(
+                branch_table, config.decoder_config, enc,
+                total_input_bytes,
+                config.soft_decision_high, config.soft_decision_low
+            );
+        }
+    );
+}
+
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+bool run_fork_test(
+    const ViterbiBranchTable<K,R,soft_t>& branch_table,
+    const ViterbiDecoder_Config<error_t>& decoder_config,
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low
+) {
+    using Core = ViterbiDecoder_Core<K,R,error_t,soft_t>;
+    const auto frame = make_noisy_frame(
+        enc, total_input_bytes, soft_decision_high, soft_decision_low, 
+        uint64_t(soft_decision_high-soft_decision_low)/2u);
+    const size_t total_input_bits = frame.total_input_bits;
+    const size_t total_symbols = frame.symbols.size();
+    // Split off a partial stage so pending symbols are carried over as well
+    const size_t total_prefix_symbols = (frame.total_bits/2u)*R + R/2u;
+    const size_t total_suffix_symbols = total_symbols - total_prefix_symbols;
+
+    std::vector<soft_t> garbage_symbols;
+    std::vector<uint8_t> expected_bytes;
+    std::vector<uint8_t> rx_input_bytes;
+    garbage_symbols.resize(total_suffix_symbols);
+    expected_bytes.resize(total_input_bytes);
+    rx_input_bytes.resize(total_input_bytes);
+
+    for (size_t i = 0u; i < total_suffix_symbols; i++) {
+        garbage_symbols[i] = ((i*7u) % 3u) ? soft_decision_high : soft_decision_low;
+    }
+    const soft_t* prefix_symbols = frame.symbols.data();
+    const soft_t* suffix_symbols = &frame.symbols[total_prefix_symbols];
+
+    auto vitdec = Core(branch_table, decoder_config);
+    vitdec.set_traceback_length(total_input_bits);
+    auto decode_suffix = [&](Core& dec, const soft_t* symbols, const uint64_t prefix_error) {
+        uint64_t error = prefix_error + dec.template push_symbols<decoder_t, uint64_t>(symbols, total_suffix_symbols);
+        error += uint64_t(dec.get_error());
+        dec.chainback(rx_input_bytes.data(), total_input_bits, 0u);
+        return error;
+    };
+    auto is_expected = [&]() {
+        return memcmp(expected_bytes.data(), rx_input_bytes.data(), total_input_bytes) == 0;
+    };
+
+    vitdec.reset();
+    const uint64_t prefix_error = vitdec.template push_symbols<decoder_t, uint64_t>(prefix_symbols, total_prefix_symbols);
+    typename Core::Snapshot snapshot;
+    vitdec.save_snapshot(snapshot);
+    const uint64_t expected_error = decode_suffix(vitdec, suffix_symbols, prefix_error);
+    memcpy(expected_bytes.data(), rx_input_bytes.data(), total_input_bytes);
+
+    // Restore after decoding the wrong symbols
+    vitdec.restore_snapshot(snapshot);
+    decode_suffix(vitdec, garbage_symbols.data(), prefix_error);
+    vitdec.restore_snapshot(snapshot);
+    if (decode_suffix(vitdec, suffix_symbols, prefix_error) != expected_error) return false;
+    if (!is_expected()) return false;
+
+    // Forks share the prefix with the parent and each other
+    vitdec.restore_snapshot(snapshot);
+    auto fork_0 = Core(branch_table, decoder_config);
+    auto fork_1 = Core(branch_table, decoder_config);
+    fork_0.fork_from(vitdec);
+    fork_1.fork_from(vitdec);
+    decode_suffix(fork_1, garbage_symbols.data(), prefix_error);
+    if (decode_suffix(fork_0, suffix_symbols, prefix_error) != expected_error) return false;
+    if (!is_expected()) return false;
+    if (decode_suffix(vitdec, suffix_symbols, prefix_error) != expected_error) return false;
+    if (!is_expected()) return false;
+
+    // Forking from a fork extends the shared prefix
+    auto fork_2 = Core(branch_table, decoder_config);
+    fork_1.restore_snapshot(snapshot);
+    const uint64_t fork_error = prefix_error + fork_1.template push_symbols<decoder_t, uint64_t>(suffix_symbols, R);
+    fork_2.fork_from(fork_1);
+    // Segments of the shared prefix only hold the decisions before each fork
+    for (const auto* decoder: { &vitdec, &fork_1, &fork_2 }) {
+        const auto& decisions = decoder->m_decisions;
+        if (decisions.get_prefix_capacity() != decisions.get_prefix_length()) return false;
+    }
+    uint64_t error = fork_error + fork_2.template push_symbols<decoder_t, uint64_t>(&suffix_symbols[R], total_suffix_symbols-R);
+    error += uint64_t(fork_2.get_error());
+    fork_2.chainback(rx_input_bytes.data(), total_input_bits, 0u);
+    if ((error != expected_error) || !is_expected()) return false;
+
+    // The fork it was forked from keeps decoding on top of the extended prefix
+    error = fork_error + fork_1.template push_symbols<decoder_t, uint64_t>(&suffix_symbols[R], total_suffix_symbols-R);
+    error += uint64_t(fork_1.get_error());
+    fork_1.chainback(rx_input_bytes.data(), total_input_bits, 0u);
+    if ((error != expected_error) || !is_expected()) return false;
+
+    // Restoring from before a fork copies the shared decisions instead of overwriting them
+    fork_1.restore_snapshot(snapshot);
+    if (fork_1.m_decisions.get_prefix_length() != 0u) return false;
+    decode_suffix(fork_1, garbage_symbols.data(), prefix_error);
+    fork_2.chainback(rx_input_bytes.data(), total_input_bits, 0u);
+    if (!is_expected()) return false;
+    fork_1.restore_snapshot(snapshot);
+    return (decode_suffix(fork_1, suffix_symbols, prefix_error) == expected_error) && is_expected();
+}
+
+template <size_t K, size_t R, typename code_t>
+void run_pruned_tests(const Code<K,R,code_t>& code, GlobalTestResults& global_results, const size_t total_input_bytes) {
+    auto enc = ConvolutionalEncoderT<K,R>(code.G.data());
+    const char* failure_message = "Pruned decode of a terminated frame does not match the full trellis.";
+
+    // A large start error in the reference makes every other start state unreachable like the pruned decoder
+    // This has enough headroom for 16bit errors with noisy symbols
+    {
+        const auto config = get_soft16_decoding_config(code.R);
+        auto ref_decoder_config = config.decoder_config;
+        ref_decoder_config.initial_non_start_error = std::numeric_limits<uint16_t>::max()/2u;
+        auto branch_table = ViterbiBranchTable<K,R,int16_t>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
+        for_each_decoder<ViterbiDecoder_Factory_u16>(
+            code, global_results, DecodeType::SOFT16, "Prune16", failure_message,
+            [&](auto tag) {
+                using decoder_t = typename decltype(tag)::type;
+                return run_pruned_test<decoder_t>(
+                    branch_table, config.decoder_config, ref_decoder_config, enc,
+                    total_input_bytes,
+                    config.soft_decision_high, config.soft_decision_low, true
+                );
+            }
+        );
+    }
+
+    // 8bit errors don't have that headroom so only the correct path is checked with noiseless symbols
+    {
+        const auto config = get_soft8_decoding_config(code.R);
+        auto branch_table = ViterbiBranchTable<K,R,int8_t>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
+        for_each_decoder<ViterbiDecoder_Factory_u8>(
+            code, global_results, DecodeType::SOFT8, "Prune8", failure_message,
+            [&](auto tag) {
+                using decoder_t = typename decltype(tag)::type;
+                return run_pruned_test<decoder_t>(
+                    branch_table, config.decoder_config, config.decoder_config, enc,
+                    total_input_bytes,
+                    config.soft_decision_high, config.soft_decision_low, false
+                );
+            }
+        );
+    }
+}
+
+template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
+bool run_pruned_test(
+    const ViterbiBranchTable<K,R,soft_t>& branch_table,
+    const ViterbiDecoder_Config<error_t>& decoder_config,
+    const ViterbiDecoder_Config<error_t>& ref_decoder_config,
+    ConvolutionalEncoderT<K,R>& enc,
+    const size_t total_input_bytes,
+    const soft_t soft_decision_high,
+    const soft_t soft_decision_low,
+    const bool is_noisy
+) {
+    using Core = ViterbiDecoder_Core<K,R,error_t,soft_t>;
+    const uint64_t noise_level = is_noisy ? uint64_t(soft_decision_high-soft_decision_low)/2u : 0u;
+    const auto frame = make_noisy_frame(enc, total_input_bytes, soft_decision_high, soft_decision_low, noise_level);
+    const size_t total_input_bits = frame.total_input_bits;
+
+    std::vector<uint8_t> expected_bytes;
+    std::vector<uint8_t> rx_input_bytes;
+    expected_bytes.resize(total_input_bytes);
+    rx_input_bytes.resize(total_input_bytes);
+
+    auto decode = [&](Core& vitdec, uint8_t* out_bytes) {
+        vitdec.set_traceback_length(total_input_bits);
+        vitdec.reset();
+        uint64_t error = decoder_t::template update<uint64_t>(vitdec, frame.symbols.data(), frame.symbols.size());
+        error += uint64_t(vitdec.get_error());
+        vitdec.chainback(out_bytes, total_input_bits, 0u);
+        return error;
+    };
+
+    auto ref_vitdec = Core(branch_table, ref_decoder_config);
+    const uint64_t expected_error = decode(ref_vitdec, expected_bytes.data());
+
+    auto vitdec = Core(branch_table, decoder_config);
+    vitdec.set_terminated_frame_length(total_input_bits);
+    const uint64_t error = decode(vitdec, rx_input_bytes.data());
+
+    const bool is_match = 
+        (error == expected_error) && 
+        (memcmp(expected_bytes.data(), rx_input_bytes.data(), total_input_bytes) == 0);
+    if (is_noisy) return is_match;
+    return is_match && (memcmp(frame.tx_input_bytes.data(), rx_input_bytes.data(), total_input_bytes) == 0);
+}
+
 template <class factory_t, size_t K, size_t R, typename code_t, typename soft_t, typename error_t>
 void run_tests(
     const Code<K,R,code_t>& code, 
@@ -159,7 +879,7 @@ void run_tests(
     const size_t total_input_bytes 
 ) {
     const Decoder_Config<soft_t, error_t> config = config_factory(code.R);
-    auto enc = ConvolutionalEncoder_ShiftRegister(code.K, code.R, code.G.data());
+    auto enc = ConvolutionalEncoderT<K,R>(code.G.data());
     auto branch_table = ViterbiBranchTable<K,R,soft_t>(code.G.data(), config.soft_decision_high, config.soft_decision_low);
     auto vitdec = ViterbiDecoder_Core<K,R,error_t,soft_t>(branch_table, config.decoder_config);
 
@@ -171,11 +891,11 @@ void run_tests(
                 const auto& skip_entry = SKIP_TESTS.find(skip_key);
                 if (skip_entry != SKIP_TESTS.end()) {
                     const char* reason = skip_entry->second;
-                    print_skip_message(code, decode_type, simd_type, reason);
+                    print_skip_message(code, get_decode_type_str(decode_type), simd_type, reason);
                     global_results.total_skipped++;
                 } else {
                     const auto res = run_test<decoder_t>(
-                        vitdec, &enc, 
+                        vitdec, enc, 
                         total_input_bytes, 
                         config.soft_decision_high, config.soft_decision_low
                     );
@@ -193,13 +913,11 @@ void run_tests(
 template <class decoder_t, size_t K, size_t R, typename soft_t, typename error_t>
 TestResult run_test(
     ViterbiDecoder_Core<K,R,error_t,soft_t>& vitdec, 
-    ConvolutionalEncoder* enc, 
+    ConvolutionalEncoderT<K,R>& enc, 
     const size_t total_input_bytes,
     const soft_t soft_decision_high,
     const soft_t soft_decision_low
 ) {
-    assert(vitdec.K == enc->K);
-    assert(vitdec.R == enc->R);
     const size_t total_input_bits = total_input_bytes*8u;
     vitdec.set_traceback_length(total_input_bits);
 
@@ -218,6 +936,7 @@ TestResult run_test(
     }
 
     generate_random_bytes(tx_input_bytes.data(), tx_input_bytes.size());
+    enc.reset();
     encode_data(
         enc, 
         tx_input_bytes.data(), tx_input_bytes.size(), 
@@ -240,6 +959,160 @@ TestResult run_test(
     return res;
 }
 
+template <size_t K, size_t R, typename code_t>
+bool run_encoder_test(const Code<K,R,code_t>& code, const size_t total_input_bytes, const size_t total_split_bytes) {
+    assert(total_split_bytes <= total_input_bytes);
+    constexpr int8_t soft_decision_high = +1;
+    constexpr int8_t soft_decision_low = -1;
+    const size_t total_symbols = (total_input_bytes*8u + K-1u) * R;
+
+    std::vector<uint8_t> input_bytes;
+    std::vector<int8_t> expected_symbols;
+    std::vector<int8_t> output_symbols;
+    input_bytes.resize(total_input_bytes);
+    expected_symbols.resize(total_symbols);
+    output_symbols.resize(total_symbols);
+    generate_random_bytes(input_bytes.data(), input_bytes.size());
+
+    auto ref_enc = ConvolutionalEncoder_ShiftRegister(code.K, code.R, code.G.data());
+    encode_data(
+        &ref_enc, 
+        input_bytes.data(), input_bytes.size(),
+        expected_symbols.data(), expected_symbols.size(),
+        soft_decision_high, soft_decision_low
+    );
+
+    // Encoder state should carry over between blocks
+    auto enc = ConvolutionalEncoderT<K,R>(code.G.data());
+    size_t curr_symbol = 0u;
+    curr_symbol += enc.encode_block(
+        input_bytes.data(), total_split_bytes, 
+        &output_symbols[curr_symbol], soft_decision_high, soft_decision_low);
+    curr_symbol += enc.encode_block(
+        &input_bytes[total_split_bytes], total_input_bytes-total_split_bytes, 
+        &output_symbols[curr_symbol], soft_decision_high, soft_decision_low);
+    curr_symbol += enc.encode_tail(&output_symbols[curr_symbol], soft_decision_high, soft_decision_low);
+
+    if (curr_symbol != total_symbols) return false;
+    return memcmp(expected_symbols.data(), output_symbols.data(), total_symbols*sizeof(int8_t)) == 0;
+}
+
+template <size_t K, size_t R, typename code_t>
+bool run_block_encoder_test(
+    ConvolutionalEncoder* enc, const Code<K,R,code_t>& code, 
+    const size_t total_input_bytes, const size_t total_split_bytes) 
+{
+    assert(total_split_bytes < total_input_bytes);
+    std::vector<uint8_t> input_bytes;
+    std::vector<uint8_t> expected_bytes;
+    std::vector<uint8_t> output_bytes;
+    input_bytes.resize(total_input_bytes);
+    expected_bytes.resize(total_input_bytes*R);
+    output_bytes.resize(total_input_bytes*R);
+    generate_random_bytes(input_bytes.data(), input_bytes.size());
+
+    auto ref_enc = ConvolutionalEncoder_ShiftRegister(code.K, code.R, code.G.data());
+    for (size_t i = 0u; i < total_input_bytes; i++) {
+        ref_enc.consume_byte(input_bytes[i], &expected_bytes[i*R]);
+    }
+
+    // Encoder state should carry over between blocks and single bytes
+    enc->reset();
+    size_t curr_byte = 0u;
+    enc->consume_block(&input_bytes[curr_byte], total_split_bytes, &output_bytes[curr_byte*R]);
+    curr_byte += total_split_bytes;
+    enc->consume_byte(input_bytes[curr_byte], &output_bytes[curr_byte*R]);
+    curr_byte += 1u;
+    enc->consume_block(&input_bytes[curr_byte], total_input_bytes-curr_byte, &output_bytes[curr_byte*R]);
+
+    return memcmp(expected_bytes.data(), output_bytes.data(), expected_bytes.size()) == 0;
+}
+
+template <size_t total_lanes, size_t K, size_t R, typename code_t>
+bool run_bitsliced_encoder_test(const Code<K,R,code_t>& code, const size_t total_input_bytes, const size_t total_split_bytes) {
+    using encoder_t = ConvolutionalEncoder_BitSliced<K,R,total_lanes>;
+    constexpr size_t total_frames = encoder_t::TOTAL_FRAMES;
+    assert(total_split_bytes <= total_input_bytes);
+    constexpr int8_t soft_decision_high = +1;
+    constexpr int8_t soft_decision_low = -1;
+    const size_t total_symbols = (total_input_bytes*8u + K-1u) * R;
+
+    std::vector<uint8_t> input_bytes;
+    std::vector<int8_t> expected_symbols;
+    std::vector<int8_t> output_symbols;
+    input_bytes.resize(total_frames*total_input_bytes);
+    expected_symbols.resize(total_frames*total_symbols);
+    output_symbols.resize(total_frames*total_symbols);
+    generate_random_bytes(input_bytes.data(), input_bytes.size());
+
+    auto ref_enc = ConvolutionalEncoderT<K,R>(code.G.data());
+    for (size_t i = 0u; i < total_frames; i++) {
+        ref_enc.reset();
+        encode_data(
+            ref_enc,
+            &input_bytes[i*total_input_bytes], total_input_bytes,
+            &expected_symbols[i*total_symbols], total_symbols,
+            soft_decision_high, soft_decision_low
+        );
+    }
+
+    // Encoder state should carry over between blocks
+    auto enc = encoder_t(code.G.data());
+    std::vector<const uint8_t*> frame_input(total_frames);
+    std::vector<int8_t*> frame_output(total_frames);
+    size_t curr_byte = 0u;
+    size_t curr_symbol = 0u;
+    auto set_frame_offsets = [&]() {
+        for (size_t i = 0u; i < total_frames; i++) {
+            frame_input[i] = &input_bytes[i*total_input_bytes + curr_byte];
+            frame_output[i] = &output_symbols[i*total_symbols + curr_symbol];
+        }
+    };
+    set_frame_offsets();
+    curr_symbol += enc.encode_block(
+        frame_input.data(), total_split_bytes, frame_output.data(), 
+        soft_decision_high, soft_decision_low);
+    curr_byte += total_split_bytes;
+    set_frame_offsets();
+    curr_symbol += enc.encode_block(
+        frame_input.data(), total_input_bytes-total_split_bytes, frame_output.data(), 
+        soft_decision_high, soft_decision_low);
+    curr_byte = total_input_bytes;
+    set_frame_offsets();
+    curr_symbol += enc.encode_tail(frame_output.data(), soft_decision_high, soft_decision_low);
+
+    if (curr_symbol != total_symbols) return false;
+    if (memcmp(expected_symbols.data(), output_symbols.data(), output_symbols.size()*sizeof(int8_t)) != 0) return false;
+
+    // Transposed layout with tail bits as zero input
+    const size_t total_bits = total_input_bytes*8u + K-1u;
+    const size_t total_split_bits = min(total_split_bytes*8u + 3u, total_bits);
+    std::vector<uint64_t> input_bits;
+    std::vector<uint64_t> output_bits;
+    input_bits.resize(total_bits*total_lanes, 0u);
+    output_bits.resize(total_bits*R*total_lanes);
+    for (size_t i = 0u; i < total_frames; i++) {
+        for (size_t t = 0u; t < total_input_bytes*8u; t++) {
+            const uint8_t byte = input_bytes[i*total_input_bytes + t/8u];
+            const uint64_t bit = (byte >> (7u - t%8u)) & 0b1;
+            input_bits[t*total_lanes + i/64u] |= bit << (i%64u);
+        }
+    }
+    enc.reset();
+    enc.encode_transposed(input_bits.data(), total_split_bits, output_bits.data());
+    enc.encode_transposed(
+        &input_bits[total_split_bits*total_lanes], total_bits-total_split_bits, 
+        &output_bits[total_split_bits*R*total_lanes]);
+    for (size_t i = 0u; i < total_frames; i++) {
+        for (size_t j = 0u; j < total_symbols; j++) {
+            const bool bit = (output_bits[j*total_lanes + i/64u] >> (i%64u)) & 0b1;
+            const int8_t symbol = bit ? soft_decision_high : soft_decision_low;
+            if (symbol != expected_symbols[i*total_symbols + j]) return false;
+        }
+    }
+    return true;
+}
+
 void print_header() {
     printf(
         "Status | %*s | %*s | %*s |  K  R | Coefficients\n",
@@ -266,12 +1139,12 @@ void print_code(const Code<K,R,code_t>& code) {
 template <size_t K, size_t R, typename code_t>
 void print_skip_message(
     const Code<K,R,code_t>& code, 
-    const DecodeType decode_type,
+    const char* category,
     const SIMD_Type simd_type,
     const char* message
 ) {
     printf("SKIP   | ");
-    printf("%*s | ", 8, get_decode_type_str(decode_type));
+    printf("%*s | ", 8, category);
     printf("%*s | ", 9, get_simd_type_string(simd_type));
     printf("%*s | %2zu %2zu | ", 16, code.name, code.K, code.R);
     print_code(code);
@@ -312,6 +1185,25 @@ void print_test_result(
     if (is_print_colors) printf(CONSOLE_RESET);
 }
 
+template <size_t K, size_t R, typename code_t>
+void print_named_test_result(
+    const bool is_pass, const Code<K,R,code_t>& code, 
+    const char* category, const char* name, const char* failure_message
+) {
+    constexpr bool is_print_colors = true;
+    if (is_print_colors) printf(is_pass ? CONSOLE_GREEN : CONSOLE_RED);
+    printf(is_pass ? "PASSED | " : "FAILED | ");
+    printf("%*s | ", 8, category);
+    printf("%*s | ", 9, name);
+    printf("%*s | %2zu %2zu | ", 16, code.name, code.K, code.R);
+    print_code(code);
+    printf("\n");
+    if (!is_pass) {
+        printf("       | %s\n", failure_message);
+    }
+    if (is_print_colors) printf(CONSOLE_RESET);
+}
+
 void print_summary(const GlobalTestResults& results) {
     printf("\n\n");
     if (results.is_pass()) {
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+// Size of each data cache level in bytes, 0 if unknown
+struct CacheInfo {
+    size_t l1d_bytes = 0u;
+    size_t l2_bytes = 0u;
+    size_t llc_bytes = 0u;
+};
+
+enum class CacheLevel {
+    L1D,
+    L2,
+    LLC,
+    DRAM,
+};
+
+inline const char* get_cache_level_str(CacheLevel level) {
+    switch (level) {
+    case CacheLevel::L1D:   return "L1D";
+    case CacheLevel::L2:    return "L2";
+    case CacheLevel::LLC:   return "LLC";
+    case CacheLevel::DRAM:  return "DRAM";
+    default:                return "unknown";
+    }
+}
+
+// Smallest cache level that can hold the given number of bytes
+// Unknown cache sizes are skipped
+inline CacheLevel get_cache_level(const CacheInfo& info, const size_t total_bytes) {
+    if (info.l1d_bytes > 0u && total_bytes <= info.l1d_bytes) return CacheLevel::L1D;
+    if (info.l2_bytes > 0u && total_bytes <= info.l2_bytes) return CacheLevel::L2;
+    if (info.llc_bytes > 0u && total_bytes <= info.llc_bytes) return CacheLevel::LLC;
+    return CacheLevel::DRAM;
+}
+
+#if defined(__linux__)
+
+// Reads a single line from a sysfs file, returns false if it doesn't exist
+inline bool read_sysfs_line(const char* filename, char* buffer, const size_t total_bytes) {
+    FILE* fp = fopen(filename, "r");
+    if (fp == nullptr) return false;
+    const bool is_read = fgets(buffer, int(total_bytes), fp) != nullptr;
+    fclose(fp);
+    if (!is_read) return false;
+    buffer[strcspn(buffer, "\n")] = '\0';
+    return true;
+}
+
+// Sizes are given as "48K" or "2048K" or "32M"
+inline size_t parse_sysfs_size(const char* str) {
+    char* end = nullptr;
+    const size_t value = size_t(strtoull(str, &end, 10));
+    if (end == nullptr) return value;
+    switch (*end) {
+    case 'K': return value*1024u;
+    case 'M': return value*1024u*1024u;
+    case 'G': return value*1024u*1024u*1024u;
+    default:  return value;
+    }
+}
+
+inline CacheInfo get_cache_info() {
+    CacheInfo info;
+    size_t max_level = 0u;
+    for (size_t index = 0u; ; index++) {
+        char path[128];
+        char level_str[32];
+        char type_str[32];
+        char size_str[32];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%zu/level", index);
+        if (!read_sysfs_line(path, level_str, sizeof(level_str))) break;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%zu/type", index);
+        if (!read_sysfs_line(path, type_str, sizeof(type_str))) continue;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%zu/size", index);
+        if (!read_sysfs_line(path, size_str, sizeof(size_str))) continue;
+        if (strcmp(type_str, "Instruction") == 0) continue;
+        const size_t level = size_t(atoi(level_str));
+        const size_t size = parse_sysfs_size(size_str);
+        if (level == 1u) info.l1d_bytes = size;
+        if (level == 2u) info.l2_bytes = size;
+        if (level >= 3u && level >= max_level) info.llc_bytes = size;
+        if (level > max_level) max_level = level;
+    }
+    // Without a third level the second level is the last level cache
+    if (max_level == 2u) info.llc_bytes = info.l2_bytes;
+    return info;
+}
+
+#elif defined(_WIN32)
+
+inline CacheInfo get_cache_info() {
+    CacheInfo info;
+    DWORD total_bytes = 0;
+    GetLogicalProcessorInformation(nullptr, &total_bytes);
+    if (total_bytes == 0) return info;
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> buffer;
+    buffer.resize(total_bytes / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!GetLogicalProcessorInformation(buffer.data(), &total_bytes)) return info;
+    size_t max_level = 0u;
+    for (const auto& entry: buffer) {
+        if (entry.Relationship != RelationCache) continue;
+        const auto& cache = entry.Cache;
+        if (cache.Type == CacheInstruction) continue;
+        if (cache.Level == 1) info.l1d_bytes = size_t(cache.Size);
+        if (cache.Level == 2) info.l2_bytes = size_t(cache.Size);
+        if (cache.Level >= 3 && size_t(cache.Level) >= max_level) info.llc_bytes = size_t(cache.Size);
+        if (size_t(cache.Level) > max_level) max_level = size_t(cache.Level);
+    }
+    if (max_level == 2u) info.llc_bytes = info.l2_bytes;
+    return info;
+}
+
+#else
+
+inline CacheInfo get_cache_info() {
+    return CacheInfo{};
+}
+
+#endif
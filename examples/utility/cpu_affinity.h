@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stddef.h>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+inline size_t get_total_cpus() {
+    const size_t total_cpus = size_t(std::thread::hardware_concurrency());
+    return (total_cpus > 0u) ? total_cpus : 1u;
+}
+
+// Pins the calling thread to a single cpu
+// Returns false if pinning failed or isn't supported on this platform
+inline bool pin_current_thread_to_cpu(const size_t cpu_index) {
+#if defined(_WIN32)
+    if (cpu_index >= sizeof(DWORD_PTR)*8u) return false;
+    const DWORD_PTR mask = DWORD_PTR(1u) << cpu_index;
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+    if (cpu_index >= size_t(CPU_SETSIZE)) return false;
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu_index, &cpu_set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set) == 0;
+#else
+    (void)cpu_index;
+    return false;
+#endif
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string>
+#include <map>
+#include <optional>
+
+// Parses a single line JSON object whose values are strings, numbers, booleans or arrays
+// Nested objects aren't supported and arrays are kept as their raw text
+// This is just enough to read back the JSON-lines files written by the examples
+class FlatJsonObject
+{
+private:
+    std::map<std::string, std::string> m_values;
+public:
+    static std::optional<FlatJsonObject> parse(const char* line) {
+        FlatJsonObject object;
+        const char* p = skip_whitespace(line);
+        if (*p != '{') return std::nullopt;
+        p = skip_whitespace(p+1);
+        if (*p == '}') return object;
+        while (true) {
+            std::string key;
+            if (!parse_string(p, key)) return std::nullopt;
+            p = skip_whitespace(p);
+            if (*p != ':') return std::nullopt;
+            p = skip_whitespace(p+1);
+            std::string value;
+            if (*p == '"') {
+                if (!parse_string(p, value)) return std::nullopt;
+            } else if (*p == '[') {
+                const char* start = p;
+                while (*p != ']' && *p != '\0') p++;
+                if (*p != ']') return std::nullopt;
+                p++;
+                value = std::string(start, size_t(p-start));
+            } else {
+                const char* start = p;
+                while (*p != ',' && *p != '}' && *p != '\0' && *p != ' ') p++;
+                value = std::string(start, size_t(p-start));
+                if (value.empty()) return std::nullopt;
+            }
+            object.m_values[key] = value;
+            p = skip_whitespace(p);
+            if (*p == ',') {
+                p = skip_whitespace(p+1);
+                continue;
+            }
+            if (*p == '}') return object;
+            return std::nullopt;
+        }
+    }
+
+    bool has(const char* key) const { return m_values.find(key) != m_values.end(); }
+
+    std::optional<std::string> get_string(const char* key) const {
+        const auto it = m_values.find(key);
+        if (it == m_values.end()) return std::nullopt;
+        return it->second;
+    }
+
+    std::optional<uint64_t> get_uint(const char* key) const {
+        const auto it = m_values.find(key);
+        if (it == m_values.end()) return std::nullopt;
+        char* end = nullptr;
+        const uint64_t value = uint64_t(strtoull(it->second.c_str(), &end, 10));
+        if (end == it->second.c_str() || *end != '\0') return std::nullopt;
+        return value;
+    }
+
+    std::optional<double> get_double(const char* key) const {
+        const auto it = m_values.find(key);
+        if (it == m_values.end()) return std::nullopt;
+        char* end = nullptr;
+        const double value = strtod(it->second.c_str(), &end);
+        if (end == it->second.c_str() || *end != '\0') return std::nullopt;
+        return value;
+    }
+
+    std::optional<bool> get_bool(const char* key) const {
+        const auto it = m_values.find(key);
+        if (it == m_values.end()) return std::nullopt;
+        if (it->second == "true") return true;
+        if (it->second == "false") return false;
+        return std::nullopt;
+    }
+private:
+    static const char* skip_whitespace(const char* p) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+        return p;
+    }
+
+    static bool parse_string(const char*& p, std::string& out) {
+        if (*p != '"') return false;
+        p++;
+        out.clear();
+        while (*p != '"') {
+            if (*p == '\0') return false;
+            if (*p == '\\') {
+                p++;
+                if (*p == '\0') return false;
+            }
+            out.push_back(*p);
+            p++;
+        }
+        p++;
+        return true;
+    }
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Hardware performance counters read through perf_event_open on linux
+// On other platforms or when the kernel doesn't expose the counters every event is unavailable
+enum class PerfEvent {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+};
+
+static constexpr size_t TOTAL_PERF_EVENTS = 5u;
+
+static constexpr PerfEvent Perf_Event_List[TOTAL_PERF_EVENTS] = {
+    PerfEvent::CYCLES,
+    PerfEvent::INSTRUCTIONS,
+    PerfEvent::L1D_MISSES,
+    PerfEvent::LLC_MISSES,
+    PerfEvent::BRANCH_MISSES,
+};
+
+inline const char* get_perf_event_str(PerfEvent event) {
+    switch (event) {
+    case PerfEvent::CYCLES:         return "cycles";
+    case PerfEvent::INSTRUCTIONS:   return "instructions";
+    case PerfEvent::L1D_MISSES:     return "l1d_misses";
+    case PerfEvent::LLC_MISSES:     return "llc_misses";
+    case PerfEvent::BRANCH_MISSES:  return "branch_misses";
+    default:                        return "unknown";
+    }
+}
+
+// Counts accumulated over many measurements
+struct PerfCounts {
+    uint64_t values[TOTAL_PERF_EVENTS] = {0u};
+    bool is_valid[TOTAL_PERF_EVENTS] = {false};
+
+    uint64_t get(PerfEvent event) const { return values[size_t(event)]; }
+    bool has(PerfEvent event) const { return is_valid[size_t(event)]; }
+};
+
+#if defined(__linux__)
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+
+// Counters are opened as a single group for the calling thread so they are scheduled together
+class PerfCounters
+{
+private:
+    int m_fds[TOTAL_PERF_EVENTS];
+    int m_leader_fd = -1;
+    size_t m_total_opened = 0u;
+    // Position of each opened event inside the group read
+    size_t m_read_index[TOTAL_PERF_EVENTS];
+public:
+    PerfCounters() {
+        for (size_t i = 0u; i < TOTAL_PERF_EVENTS; i++) {
+            m_fds[i] = -1;
+            m_read_index[i] = 0u;
+        }
+        for (const auto event: Perf_Event_List) {
+            const size_t i = size_t(event);
+            m_fds[i] = open_event(event, m_leader_fd);
+            if (m_fds[i] == -1) continue;
+            if (m_leader_fd == -1) m_leader_fd = m_fds[i];
+            m_read_index[i] = m_total_opened;
+            m_total_opened++;
+        }
+    }
+    ~PerfCounters() {
+        for (auto fd: m_fds) {
+            if (fd != -1) close(fd);
+        }
+    }
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool is_available() const { return m_leader_fd != -1; }
+
+    void start() {
+        if (!is_available()) return;
+        ioctl(m_leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    // Stops counting and adds the counts since start() onto the accumulator
+    void stop(PerfCounts& accumulator) {
+        if (!is_available()) return;
+        ioctl(m_leader_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        // PERF_FORMAT_GROUP gives the number of events followed by each value
+        uint64_t buffer[1u + TOTAL_PERF_EVENTS];
+        const ssize_t total_read = read(m_leader_fd, buffer, sizeof(buffer));
+        if (total_read < ssize_t(sizeof(uint64_t))) return;
+        const size_t total_values = size_t(buffer[0]);
+        for (size_t i = 0u; i < TOTAL_PERF_EVENTS; i++) {
+            if (m_fds[i] == -1) continue;
+            const size_t index = m_read_index[i];
+            if (index >= total_values) continue;
+            accumulator.values[i] += buffer[1u + index];
+            accumulator.is_valid[i] = true;
+        }
+    }
+private:
+    static int open_event(PerfEvent event, int group_fd) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = (group_fd == -1) ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        switch (event) {
+        case PerfEvent::CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfEvent::INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfEvent::L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config =
+                uint64_t(PERF_COUNT_HW_CACHE_L1D) |
+                (uint64_t(PERF_COUNT_HW_CACHE_OP_READ) << 8u) |
+                (uint64_t(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16u);
+            break;
+        case PerfEvent::LLC_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PerfEvent::BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        default:
+            return -1;
+        }
+        // Measure the calling thread on any cpu
+        const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+        return (fd < 0) ? -1 : int(fd);
+    }
+};
+
+#else
+
+class PerfCounters
+{
+public:
+    bool is_available() const { return false; }
+    void start() {}
+    void stop(PerfCounts& accumulator) { (void)accumulator; }
+};
+
+#endif
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <cmath>
+#include <vector>
+
+// Two sided 95% critical values of the student t-distribution for 1 to 30 degrees of freedom
+static constexpr double STUDENT_T_95[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+     2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+     2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+inline double get_student_t_95(const size_t degrees_of_freedom) {
+    if (degrees_of_freedom == 0u) return 0.0;
+    if (degrees_of_freedom <= 30u) return STUDENT_T_95[degrees_of_freedom-1u];
+    return 1.960;
+}
+
+// Running mean and variance using Welford's algorithm so samples don't need to be stored
+class RunningStatistics
+{
+private:
+    size_t m_total_samples = 0;
+    double m_mean = 0.0;
+    double m_m2 = 0.0;
+    double m_min = 0.0;
+    double m_max = 0.0;
+public:
+    void push(const double x) {
+        m_total_samples++;
+        const double delta = x - m_mean;
+        m_mean += delta / double(m_total_samples);
+        m_m2 += delta * (x - m_mean);
+        if (m_total_samples == 1u || x < m_min) m_min = x;
+        if (m_total_samples == 1u || x > m_max) m_max = x;
+    }
+    size_t get_total_samples() const { return m_total_samples; }
+    double get_mean() const { return m_mean; }
+    double get_min() const { return m_min; }
+    double get_max() const { return m_max; }
+    // Sample variance with Bessel's correction
+    double get_variance() const {
+        if (m_total_samples < 2u) return 0.0;
+        return m_m2 / double(m_total_samples-1u);
+    }
+    double get_stddev() const { return std::sqrt(get_variance()); }
+    // Half width of the 95% confidence interval of the mean
+    double get_ci95() const {
+        if (m_total_samples < 2u) return 0.0;
+        const double standard_error = get_stddev() / std::sqrt(double(m_total_samples));
+        return get_student_t_95(m_total_samples-1u) * standard_error;
+    }
+};
+
+// Log-linear histogram of integer samples which gives percentiles in constant memory
+// Each power of two is split into 2^TOTAL_SUB_BITS buckets so the relative error is at most 2^-TOTAL_SUB_BITS
+class LogHistogram
+{
+private:
+    static constexpr size_t TOTAL_SUB_BITS = 5u;
+    static constexpr size_t TOTAL_SUB_BUCKETS = size_t(1u) << TOTAL_SUB_BITS;
+    static constexpr size_t TOTAL_BUCKETS = (64u-TOTAL_SUB_BITS+1u)*TOTAL_SUB_BUCKETS;
+    std::vector<uint64_t> m_buckets;
+    size_t m_total_samples = 0;
+public:
+    LogHistogram(): m_buckets(TOTAL_BUCKETS, 0u) {}
+    void push(const uint64_t x) {
+        m_buckets[get_bucket_index(x)]++;
+        m_total_samples++;
+    }
+    size_t get_total_samples() const { return m_total_samples; }
+    // Nearest rank percentile where p is between 0 and 1
+    uint64_t get_percentile(const double p) const {
+        if (m_total_samples == 0u) return 0u;
+        double rank_real = std::ceil(p * double(m_total_samples));
+        if (rank_real < 1.0) rank_real = 1.0;
+        const uint64_t rank = uint64_t(rank_real);
+        uint64_t total_seen = 0u;
+        for (size_t i = 0u; i < TOTAL_BUCKETS; i++) {
+            total_seen += m_buckets[i];
+            if (total_seen >= rank) return get_bucket_midpoint(i);
+        }
+        return get_bucket_midpoint(TOTAL_BUCKETS-1u);
+    }
+private:
+    static size_t get_bucket_index(const uint64_t x) {
+        if (x < TOTAL_SUB_BUCKETS) return size_t(x);
+        size_t exponent = TOTAL_SUB_BITS;
+        while ((x >> exponent) > 1u) exponent++;
+        const size_t shift = exponent - TOTAL_SUB_BITS;
+        const size_t sub_index = size_t(x >> shift) & (TOTAL_SUB_BUCKETS-1u);
+        return (shift+1u)*TOTAL_SUB_BUCKETS + sub_index;
+    }
+    static uint64_t get_bucket_midpoint(const size_t index) {
+        if (index < TOTAL_SUB_BUCKETS) return uint64_t(index);
+        const size_t shift = index/TOTAL_SUB_BUCKETS - 1u;
+        const uint64_t sub_index = uint64_t(index % TOTAL_SUB_BUCKETS);
+        const uint64_t lower = (uint64_t(TOTAL_SUB_BUCKETS) + sub_index) << shift;
+        const uint64_t half_width = (shift > 0u) ? (uint64_t(1u) << (shift-1u)) : 0u;
+        return lower + half_width;
+    }
+};
+
+// Summary of timing samples in nanoseconds
+class SampleStatistics
+{
+private:
+    RunningStatistics m_running;
+    LogHistogram m_histogram;
+public:
+    void push(const uint64_t x) {
+        m_running.push(double(x));
+        m_histogram.push(x);
+    }
+    size_t get_total_samples() const { return m_running.get_total_samples(); }
+    double get_mean() const { return m_running.get_mean(); }
+    double get_stddev() const { return m_running.get_stddev(); }
+    double get_ci95() const { return m_running.get_ci95(); }
+    double get_min() const { return m_running.get_min(); }
+    double get_max() const { return m_running.get_max(); }
+    // Percentiles are clamped to the exact range since buckets are approximate
+    double get_percentile(const double p) const {
+        const double x = double(m_histogram.get_percentile(p));
+        if (x < get_min()) return get_min();
+        if (x > get_max()) return get_max();
+        return x;
+    }
+    double get_median() const { return get_percentile(0.5); }
+};
+
+// Two sided critical value of the standard normal distribution for a confidence level in (0,1)
+// Solved by bisection on erfc since it is only needed once per run
+inline double get_normal_critical_value(const double confidence) {
+    const double alpha = 1.0 - confidence;
+    double lower = 0.0;
+    double upper = 40.0;
+    for (size_t i = 0; i < 100u; i++) {
+        const double z = 0.5*(lower + upper);
+        // Probability of |Z| > z
+        if (std::erfc(z / std::sqrt(2.0)) > alpha) {
+            lower = z;
+        } else {
+            upper = z;
+        }
+    }
+    return 0.5*(lower + upper);
+}
+
+struct ProportionInterval {
+    double estimate = 0.0;
+    double lower = 0.0;
+    double upper = 1.0;
+    // Half width of the interval relative to the estimate, infinite if there are no events
+    double get_relative_precision() const {
+        if (estimate <= 0.0) return INFINITY;
+        return 0.5*(upper - lower) / estimate;
+    }
+};
+
+// Wilson score interval given the proportion and a possibly fractional number of trials
+inline ProportionInterval get_wilson_interval_from_proportion(const double p, const double n, const double z) {
+    ProportionInterval interval;
+    if (n <= 0.0) return interval;
+    const double z2 = z*z;
+    const double denom = 1.0 + z2/n;
+    const double centre = (p + z2/(2.0*n)) / denom;
+    const double half_width = (z/denom) * std::sqrt(p*(1.0-p)/n + z2/(4.0*n*n));
+    interval.estimate = p;
+    interval.lower = std::fmax(0.0, centre - half_width);
+    interval.upper = std::fmin(1.0, centre + half_width);
+    return interval;
+}
+
+// Wilson score interval for a binomial proportion
+// This stays inside [0,1] and has sensible coverage even with very few events
+inline ProportionInterval get_wilson_interval(const size_t total_events, const size_t total_trials, const double z) {
+    ProportionInterval interval;
+    if (total_trials == 0u) return interval;
+    const double p = double(total_events) / double(total_trials);
+    return get_wilson_interval_from_proportion(p, double(total_trials), z);
+}
+
+// Wilson score interval for a proportion of trials that are grouped into equal sized clusters
+// Events within a cluster are correlated, e.g. bit errors from a Viterbi decoder arrive in bursts inside a frame
+// The variance between clusters gives the design effect which shrinks the number of trials to an effective sample size
+// This needs the sum of the squared number of events in each cluster, and is never narrower than the binomial interval
+inline ProportionInterval get_clustered_wilson_interval(
+    const size_t total_events, const uint64_t total_squared_cluster_events,
+    const size_t total_clusters, const size_t cluster_size, const double z)
+{
+    ProportionInterval interval;
+    if (total_clusters == 0u || cluster_size == 0u) return interval;
+    const double N = double(total_clusters);
+    const double m = double(cluster_size);
+    const double n = N*m;
+    const double p = double(total_events) / n;
+    double design_effect = 1.0;
+    const double binomial_variance = m*p*(1.0-p);
+    if (total_clusters >= 2u && binomial_variance > 0.0) {
+        const double E = double(total_events);
+        const double cluster_variance = (double(total_squared_cluster_events) - E*E/N) / (N-1.0);
+        design_effect = std::fmax(1.0, cluster_variance / binomial_variance);
+    }
+    return get_wilson_interval_from_proportion(p, n/design_effect, z);
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "../arch/simd_flags.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Mixing function from splitmix64 which is used to expand a single seed into a full generator state
+// Repeatedly calling this with x += 0x9E3779B97F4A7C15 gives the splitmix64 sequence
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t rotl_u64(const uint64_t x, const int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// xoshiro256++ from David Blackman and Sebastiano Vigna
+// https://prng.di.unimi.it/xoshiro256plusplus.c
+// Satisfies UniformRandomBitGenerator so it can be used with <random> distributions
+class Xoshiro256
+{
+public:
+    using result_type = uint64_t;
+private:
+    uint64_t m_state[4];
+public:
+    explicit Xoshiro256(const uint64_t seed = 0u) { reseed(seed); }
+
+    void reseed(const uint64_t seed) {
+        for (size_t i = 0; i < 4; i++) {
+            m_state[i] = splitmix64(seed + uint64_t(i)*0x9E3779B97F4A7C15ull);
+        }
+    }
+
+    static constexpr result_type min() { return 0u; }
+    static constexpr result_type max() { return ~result_type(0u); }
+
+    result_type operator()() {
+        uint64_t* s = m_state;
+        const uint64_t result = rotl_u64(s[0] + s[3], 23) + s[0];
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl_u64(s[3], 45);
+        return result;
+    }
+
+    /// @brief Advance the state by 2^128 calls to give a non-overlapping subsequence
+    void jump() {
+        static constexpr uint64_t JUMP[4] = {
+            0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+            0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull,
+        };
+        uint64_t s[4] = { 0u, 0u, 0u, 0u };
+        for (size_t i = 0; i < 4; i++) {
+            for (int b = 0; b < 64; b++) {
+                if (JUMP[i] & (uint64_t(1u) << b)) {
+                    for (size_t j = 0; j < 4; j++) s[j] ^= m_state[j];
+                }
+                operator()();
+            }
+        }
+        for (size_t j = 0; j < 4; j++) m_state[j] = s[j];
+    }
+
+    const uint64_t* get_state() const { return m_state; }
+};
+
+#if defined(__AVX2__)
+template <int k>
+inline __m256i rotl_u64_avx2(const __m256i x) {
+    return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+}
+#endif
+
+// Runs 8 independent xoshiro256++ generators side by side
+// The state is stored as structure of arrays so each step is a handful of 64bit vector ops
+// Each lane starts 2^128 steps after the previous one so the streams never overlap
+class Xoshiro256_Lanes
+{
+public:
+    static constexpr size_t TOTAL_LANES = 8u;
+private:
+    alignas(32) uint64_t m_state[4][TOTAL_LANES];
+public:
+    explicit Xoshiro256_Lanes(const uint64_t seed = 0u) { reseed(seed); }
+
+    void reseed(const uint64_t seed) {
+        Xoshiro256 rng(seed);
+        for (size_t i = 0; i < TOTAL_LANES; i++) {
+            const uint64_t* s = rng.get_state();
+            for (size_t j = 0; j < 4; j++) m_state[j][i] = s[j];
+            rng.jump();
+        }
+    }
+
+    /// @brief Write the next output from every lane
+    void generate(uint64_t* out) {
+        #if defined(__AVX2__)
+        for (size_t i = 0; i < TOTAL_LANES; i += 4) {
+            __m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&m_state[0][i]));
+            __m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&m_state[1][i]));
+            __m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&m_state[2][i]));
+            __m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&m_state[3][i]));
+            const __m256i result = _mm256_add_epi64(rotl_u64_avx2<23>(_mm256_add_epi64(s0, s3)), s0);
+            const __m256i t = _mm256_slli_epi64(s1, 17);
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = rotl_u64_avx2<45>(s3);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&m_state[0][i]), s0);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&m_state[1][i]), s1);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&m_state[2][i]), s2);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&m_state[3][i]), s3);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&out[i]), result);
+        }
+        #else
+        for (size_t i = 0; i < TOTAL_LANES; i++) {
+            uint64_t& s0 = m_state[0][i];
+            uint64_t& s1 = m_state[1][i];
+            uint64_t& s2 = m_state[2][i];
+            uint64_t& s3 = m_state[3][i];
+            out[i] = rotl_u64(s0 + s3, 23) + s0;
+            const uint64_t t = s1 << 17;
+            s2 ^= s0;
+            s3 ^= s1;
+            s1 ^= s2;
+            s0 ^= s3;
+            s2 ^= t;
+            s3 = rotl_u64(s3, 45);
+        }
+        #endif
+    }
+
+    void fill_bytes(uint8_t* data, const size_t total_bytes) {
+        constexpr size_t BLOCK_SIZE = TOTAL_LANES*sizeof(uint64_t);
+        alignas(32) uint64_t block[TOTAL_LANES];
+        size_t offset = 0;
+        while (offset < total_bytes) {
+            generate(block);
+            const size_t M = ((total_bytes - offset) < BLOCK_SIZE) ? (total_bytes - offset) : BLOCK_SIZE;
+            memcpy(&data[offset], block, M);
+            offset += M;
+        }
+    }
+};
+
+// Map a random 32bit value onto [0,N) without a division (Lemire's method)
+// The bias is at most N/2^32 which is negligible for the ranges used in simulation
+inline uint32_t get_random_below(const uint32_t x, const uint32_t N) {
+    return uint32_t((uint64_t(x) * uint64_t(N)) >> 32);
+}
@@ -0,0 +1,24 @@
+/* Copyright (c) 2023 William Yang. All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see https://opensource.org/licenses/MIT.
+ */
+#pragma once
+#include "../convolutional_encoder_clmul.h"
+#include <stdint.h>
+#include "arm_neon.h"
+
+struct CLMUL_PMULL {
+    static inline void multiply(const uint64_t a, const uint64_t b, uint64_t& lo, uint64_t& hi) {
+        const poly128_t P = vmull_p64(poly64_t(a), poly64_t(b));
+        const uint64x2_t V = vreinterpretq_u64_p128(P);
+        lo = vgetq_lane_u64(V, 0);
+        hi = vgetq_lane_u64(V, 1);
+    }
+
+    static inline uint64_t reverse_byte_bits(const uint64_t x) {
+        return vget_lane_u64(vreinterpret_u64_u8(vrbit_u8(vcreate_u8(x))), 0);
+    }
+};
+
+/// @brief Carry-less multiply encoder using PMULL from the ARMv8 crypto extension.
+using ConvolutionalEncoder_PMULL = ConvolutionalEncoder_CLMUL<CLMUL_PMULL>;
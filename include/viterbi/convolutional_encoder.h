@@ -26,5 +26,12 @@ public:
 
     /// @brief Output R bytes for each input byte
     virtual void consume_byte(const uint8_t x, uint8_t* y) = 0;
+
+    /// @brief Output R bytes for each input byte over a block of N input bytes
+    virtual void consume_block(const uint8_t* x, const size_t N, uint8_t* y) {
+        for (size_t i = 0u; i < N; i++) {
+            consume_byte(x[i], &y[i*R]);
+        }
+    }
 };
 
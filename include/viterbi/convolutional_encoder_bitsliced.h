@@ -0,0 +1,220 @@
+/* Copyright (c) 2023 William Yang. All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see https://opensource.org/licenses/MIT.
+ */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+/// @brief Convolutional encoder which encodes many independent frames at once by bit slicing.
+///        Bit f of each 64bit word belongs to frame f, so every frame's shift register is updated
+///        with a few xors per input bit that are shared across all frames.
+///        With multiple lanes there are 64*total_lanes frames, and the inner loops over lanes vectorise.
+///        The transposed layout stores input bit t of all frames as total_lanes words,
+///        and output symbol t*R+j of all frames as total_lanes words.
+template <size_t constraint_length, size_t code_rate, size_t total_lanes = 1u>
+class ConvolutionalEncoder_BitSliced
+{
+public:
+    static constexpr size_t K = constraint_length;
+    static constexpr size_t R = code_rate;
+    static constexpr size_t TOTAL_LANES = total_lanes;
+    static constexpr size_t TOTAL_WORD_BITS = 64u;
+    static constexpr size_t TOTAL_FRAMES = TOTAL_WORD_BITS*TOTAL_LANES;
+    static constexpr size_t TOTAL_STATE_BITS = K-1u;
+    static_assert(K > 1u, "Constraint length must be greater than 1");
+    static_assert(R > 1u, "Code rate must be greater than 1");
+    static_assert(TOTAL_LANES > 0u, "Must have at least one lane");
+private:
+    // tap_masks[j][k] is all ones if generator j uses the input delayed by k bits
+    uint64_t tap_masks[R][K];
+    // reg[k] is the input delayed by k+1 bits for all frames
+    uint64_t reg[TOTAL_STATE_BITS][TOTAL_LANES];
+public:
+    template <typename code_t>
+    explicit ConvolutionalEncoder_BitSliced(const code_t* G) {
+        for (size_t j = 0u; j < R; j++) {
+            for (size_t k = 0u; k < K; k++) {
+                const bool is_tap = (uint64_t(G[j]) >> k) & uint64_t(1u);
+                tap_masks[j][k] = is_tap ? ~uint64_t(0u) : uint64_t(0u);
+            }
+        }
+        reset();
+    }
+
+    /// @brief Resets the registers of all frames to state 0.
+    void reset() {
+        for (size_t k = 0u; k < TOTAL_STATE_BITS; k++) {
+            for (size_t l = 0u; l < TOTAL_LANES; l++) {
+                reg[k][l] = 0u;
+            }
+        }
+    }
+
+    /// @brief Size of the tap masks which replace a lookup table.
+    size_t get_table_size() const {
+        return sizeof(tap_masks);
+    }
+
+    /// @brief Encodes one input bit of every frame.
+    /// @param x Input bit of each frame stored as TOTAL_LANES words.
+    /// @param y Output bits of each frame stored as R*TOTAL_LANES words.
+    void encode_bit(const uint64_t* x, uint64_t* y) {
+        for (size_t j = 0u; j < R; j++) {
+            // Accumulate all lanes together so they can be vectorised
+            uint64_t v[TOTAL_LANES];
+            for (size_t l = 0u; l < TOTAL_LANES; l++) {
+                v[l] = x[l] & tap_masks[j][0];
+            }
+            for (size_t k = 1u; k < K; k++) {
+                const uint64_t mask = tap_masks[j][k];
+                for (size_t l = 0u; l < TOTAL_LANES; l++) {
+                    v[l] ^= reg[k-1u][l] & mask;
+                }
+            }
+            for (size_t l = 0u; l < TOTAL_LANES; l++) {
+                y[j*TOTAL_LANES + l] = v[l];
+            }
+        }
+
+        for (size_t k = TOTAL_STATE_BITS-1u; k > 0u; k--) {
+            for (size_t l = 0u; l < TOTAL_LANES; l++) {
+                reg[k][l] = reg[k-1u][l];
+            }
+        }
+        for (size_t l = 0u; l < TOTAL_LANES; l++) {
+            reg[0][l] = x[l];
+        }
+    }
+
+    /// @brief Encodes total_bits input bits of every frame in the transposed layout.
+    /// @param x Input of size total_bits*TOTAL_LANES words.
+    /// @param y Output of size total_bits*R*TOTAL_LANES words.
+    void encode_transposed(const uint64_t* x, const size_t total_bits, uint64_t* y) {
+        // Bits which depend on the previous block's input are read from the registers
+        const size_t total_head_bits = (total_bits < TOTAL_STATE_BITS) ? total_bits : TOTAL_STATE_BITS;
+        for (size_t t = 0u; t < total_head_bits; t++) {
+            encode_bit(&x[t*TOTAL_LANES], &y[t*R*TOTAL_LANES]);
+        }
+        if (total_bits <= TOTAL_STATE_BITS) {
+            return;
+        }
+
+        // Remaining bits read their delayed inputs directly instead of shifting the registers
+        for (size_t t = TOTAL_STATE_BITS; t < total_bits; t++) {
+            for (size_t j = 0u; j < R; j++) {
+                uint64_t v[TOTAL_LANES];
+                for (size_t l = 0u; l < TOTAL_LANES; l++) {
+                    v[l] = x[t*TOTAL_LANES + l] & tap_masks[j][0];
+                }
+                for (size_t k = 1u; k < K; k++) {
+                    const uint64_t mask = tap_masks[j][k];
+                    for (size_t l = 0u; l < TOTAL_LANES; l++) {
+                        v[l] ^= x[(t-k)*TOTAL_LANES + l] & mask;
+                    }
+                }
+                for (size_t l = 0u; l < TOTAL_LANES; l++) {
+                    y[(t*R + j)*TOTAL_LANES + l] = v[l];
+                }
+            }
+        }
+
+        for (size_t k = 0u; k < TOTAL_STATE_BITS; k++) {
+            for (size_t l = 0u; l < TOTAL_LANES; l++) {
+                reg[k][l] = x[(total_bits-1u-k)*TOTAL_LANES + l];
+            }
+        }
+    }
+
+    /// @brief Encodes input bytes of every frame into R soft decision symbols per bit.
+    /// @param x TOTAL_FRAMES pointers to total_bytes input bytes.
+    /// @param y TOTAL_FRAMES pointers to total_bytes*8*R output symbols.
+    /// @return Number of symbols written per frame.
+    template <typename soft_t>
+    size_t encode_block(
+        const uint8_t* const* x, const size_t total_bytes, soft_t* const* y,
+        const soft_t soft_decision_high, const soft_t soft_decision_low)
+    {
+        uint64_t in_bits[8u][TOTAL_LANES];
+        uint64_t out_bits[R*TOTAL_LANES];
+        for (size_t i = 0u; i < total_bytes; i++) {
+            transpose_byte(x, i, in_bits);
+            for (size_t b = 0u; b < 8u; b++) {
+                encode_bit(in_bits[b], out_bits);
+                const size_t offset = (i*8u + b)*R;
+                emit_symbols(out_bits, y, offset, soft_decision_high, soft_decision_low);
+            }
+        }
+        return total_bytes*8u*R;
+    }
+
+    /// @brief Flushes K-1 zero bits in every frame to terminate the trellis at state 0.
+    /// @param y TOTAL_FRAMES pointers to (K-1)*R output symbols.
+    /// @return Number of symbols written per frame.
+    template <typename soft_t>
+    size_t encode_tail(soft_t* const* y, const soft_t soft_decision_high, const soft_t soft_decision_low) {
+        const uint64_t in_bits[TOTAL_LANES] = {0u};
+        uint64_t out_bits[R*TOTAL_LANES];
+        for (size_t b = 0u; b < TOTAL_STATE_BITS; b++) {
+            encode_bit(in_bits, out_bits);
+            emit_symbols(out_bits, y, b*R, soft_decision_high, soft_decision_low);
+        }
+        return TOTAL_STATE_BITS*R;
+    }
+private:
+    // Gathers byte i of every frame so that in_bits[b] holds bit b of all frames
+    // where bit 0 is the most significant bit of the byte since it is transmitted first
+    static void transpose_byte(const uint8_t* const* x, const size_t i, uint64_t (&in_bits)[8u][TOTAL_LANES]) {
+        for (size_t b = 0u; b < 8u; b++) {
+            for (size_t l = 0u; l < TOTAL_LANES; l++) {
+                in_bits[b][l] = 0u;
+            }
+        }
+
+        for (size_t l = 0u; l < TOTAL_LANES; l++) {
+            for (size_t q = 0u; q < 8u; q++) {
+                // 8x8 bit matrix where row r is the byte from frame r in this group
+                const size_t frame_offset = l*TOTAL_WORD_BITS + q*8u;
+                uint64_t m = 0u;
+                for (size_t r = 0u; r < 8u; r++) {
+                    m |= uint64_t(x[frame_offset + r][i]) << (r*8u);
+                }
+                m = transpose_8x8(m);
+                // Row c now has bit c from each frame
+                for (size_t b = 0u; b < 8u; b++) {
+                    const uint64_t row = (m >> ((7u-b)*8u)) & uint64_t(0xFF);
+                    in_bits[b][l] |= row << (q*8u);
+                }
+            }
+        }
+    }
+
+    // Swaps bit (8*r + c) with bit (8*c + r)
+    static uint64_t transpose_8x8(uint64_t m) {
+        uint64_t t;
+        t = (m ^ (m >> 7u))  & uint64_t(0x00AA00AA00AA00AAull);
+        m = m ^ t ^ (t << 7u);
+        t = (m ^ (m >> 14u)) & uint64_t(0x0000CCCC0000CCCCull);
+        m = m ^ t ^ (t << 14u);
+        t = (m ^ (m >> 28u)) & uint64_t(0x00000000F0F0F0F0ull);
+        m = m ^ t ^ (t << 28u);
+        return m;
+    }
+
+    template <typename soft_t>
+    static void emit_symbols(
+        const uint64_t* out_bits, soft_t* const* y, const size_t offset,
+        const soft_t soft_decision_high, const soft_t soft_decision_low)
+    {
+        for (size_t l = 0u; l < TOTAL_LANES; l++) {
+            for (size_t f = 0u; f < TOTAL_WORD_BITS; f++) {
+                soft_t* frame_out = &y[l*TOTAL_WORD_BITS + f][offset];
+                for (size_t j = 0u; j < R; j++) {
+                    const bool bit = (out_bits[j*TOTAL_LANES + l] >> f) & uint64_t(1u);
+                    frame_out[j] = bit ? soft_decision_high : soft_decision_low;
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,163 @@
+/* Copyright (c) 2023 William Yang. All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see https://opensource.org/licenses/MIT.
+ */
+#pragma once
+#include "./convolutional_encoder.h"
+#include <vector>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+/// @brief Convolutional encoder which uses a carry-less multiply to encode 64 bits at a time.
+///        Each output stream is the GF(2) polynomial product of the input bits and a generator.
+///        If the input stream has bit i as the coefficient of D^i then for generator G[j]
+///        Y_j(D) = X(D) * G_j(D), where the taps of G_j are stored with the current bit as D^0.
+///        The low 64 bits of the product are the outputs of the current word.
+///        The high bits are the contribution of the current word to the next word, which we carry over.
+///        The output byte layout is the same as ConvolutionalEncoder_Lookup.
+/// @tparam clmul_t Provides static void multiply(uint64_t a, uint64_t b, uint64_t& lo, uint64_t& hi)
+///                 and static uint64_t reverse_byte_bits(uint64_t x) for the target instruction set.
+template <class clmul_t>
+class ConvolutionalEncoder_CLMUL: public ConvolutionalEncoder
+{
+private:
+    static constexpr size_t TOTAL_WORD_BITS = 64u;
+    static constexpr size_t TOTAL_WORD_BYTES = 8u;
+    // Spread table can interleave up to 8 output streams into a single 64bit word
+    static constexpr size_t MAX_SPREAD_CODE_RATE = 8u;
+    std::vector<uint64_t> G;
+    std::vector<uint64_t> carry;
+    std::vector<uint64_t> spread_table;
+    std::vector<uint64_t> out;
+public:
+    template <typename code_t>
+    ConvolutionalEncoder_CLMUL(const size_t constraint_length, const size_t code_rate, const code_t* _G)
+    :   ConvolutionalEncoder(constraint_length, code_rate),
+        G(R), carry(R), out(R)
+    {
+        assert(K > 1u);
+        assert(R > 1u);
+        assert(K <= TOTAL_WORD_BITS);   // generator polynomial must fit inside 64bit multiplicand
+        const uint64_t CONSTRAINT_MASK = (K == TOTAL_WORD_BITS) ? ~uint64_t(0u) : ((uint64_t(1u) << K) - 1u);
+        for (size_t i = 0u; i < R; i++) {
+            G[i] = uint64_t(_G[i]) & CONSTRAINT_MASK;
+        }
+        generate_spread_table();
+        reset();
+    }
+
+    void reset() override {
+        for (auto& v: carry) {
+            v = 0u;
+        }
+    }
+
+    void consume_byte(const uint8_t x, uint8_t* y) override {
+        consume_word(uint64_t(x), 1u, y);
+    }
+
+    size_t get_table_size() const {
+        return (G.size() + spread_table.size()) * sizeof(uint64_t);
+    }
+
+    void consume_block(const uint8_t* x, const size_t N, uint8_t* y) override {
+        size_t curr_byte = 0u;
+        for (; (curr_byte + TOTAL_WORD_BYTES) <= N; curr_byte += TOTAL_WORD_BYTES) {
+            uint64_t word = 0u;
+            for (size_t i = 0u; i < TOTAL_WORD_BYTES; i++) {
+                word |= uint64_t(x[curr_byte+i]) << (i*8u);
+            }
+            consume_word(word, TOTAL_WORD_BYTES, &y[curr_byte*R]);
+        }
+
+        const size_t remain_bytes = N - curr_byte;
+        if (remain_bytes > 0u) {
+            uint64_t word = 0u;
+            for (size_t i = 0u; i < remain_bytes; i++) {
+                word |= uint64_t(x[curr_byte+i]) << (i*8u);
+            }
+            consume_word(word, remain_bytes, &y[curr_byte*R]);
+        }
+    }
+private:
+    // Input bytes are stored from first to last byte starting at the least significant byte
+    void consume_word(const uint64_t x, const size_t total_bytes, uint8_t* y) {
+        // Each byte is transmitted from its most significant bit
+        // Reverse each byte so the first bit is the lowest polynomial coefficient
+        const uint64_t X = clmul_t::reverse_byte_bits(x);
+        const size_t total_bits = total_bytes*8u;
+
+        for (size_t j = 0u; j < R; j++) {
+            uint64_t lo, hi;
+            clmul_t::multiply(X, G[j], lo, hi);
+            lo ^= carry[j];
+            out[j] = lo;
+            if (total_bits == TOTAL_WORD_BITS) {
+                carry[j] = hi;
+            } else {
+                // Product of a partial word fits inside (total_bits + K-1) <= 127 bits
+                carry[j] = (lo >> total_bits) | (hi << (TOTAL_WORD_BITS-total_bits));
+            }
+        }
+
+        interleave_bits(total_bytes, y);
+    }
+
+    // Output bit i*R+j is the j-th generator's output for the i-th input bit
+    void interleave_bits(const size_t total_bytes, uint8_t* y) {
+        // Dispatch to compile time code rate so the interleaving loops are unrolled
+        switch (R) {
+        case 2: interleave_bits_spread<2>(total_bytes, y); return;
+        case 3: interleave_bits_spread<3>(total_bytes, y); return;
+        case 4: interleave_bits_spread<4>(total_bytes, y); return;
+        case 5: interleave_bits_spread<5>(total_bytes, y); return;
+        case 6: interleave_bits_spread<6>(total_bytes, y); return;
+        case 7: interleave_bits_spread<7>(total_bytes, y); return;
+        case 8: interleave_bits_spread<8>(total_bytes, y); return;
+        default: break;
+        }
+
+        memset(y, 0, total_bytes*R);
+        const size_t total_bits = total_bytes*8u;
+        size_t curr_bit = 0u;
+        for (size_t i = 0u; i < total_bits; i++) {
+            for (size_t j = 0u; j < R; j++) {
+                const uint8_t bit_out = uint8_t((out[j] >> i) & 0b1);
+                y[curr_bit/8u] |= (bit_out << (curr_bit%8u));
+                curr_bit++;
+            }
+        }
+    }
+
+    template <size_t CODE_RATE>
+    void interleave_bits_spread(const size_t total_bytes, uint8_t* y) {
+        static_assert(CODE_RATE <= MAX_SPREAD_CODE_RATE, "Spread table only supports up to 8 output streams");
+        for (size_t i = 0u; i < total_bytes; i++) {
+            uint64_t v = 0u;
+            for (size_t j = 0u; j < CODE_RATE; j++) {
+                const uint8_t b = uint8_t(out[j] >> (i*8u));
+                v |= spread_table[b] << j;
+            }
+            for (size_t k = 0u; k < CODE_RATE; k++) {
+                y[i*CODE_RATE + k] = uint8_t(v >> (k*8u));
+            }
+        }
+    }
+
+    // Maps bit i of a byte to bit i*R
+    void generate_spread_table() {
+        if (R > MAX_SPREAD_CODE_RATE) {
+            return;
+        }
+        spread_table.resize(256);
+        for (size_t b = 0u; b < 256u; b++) {
+            uint64_t v = 0u;
+            for (size_t i = 0u; i < 8u; i++) {
+                v |= uint64_t((b >> i) & 0b1) << (i*R);
+            }
+            spread_table[b] = v;
+        }
+    }
+};
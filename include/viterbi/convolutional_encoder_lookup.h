@@ -56,6 +56,10 @@ public:
             y[j] = v[j];
         }
     }
+
+    size_t get_table_size() const {
+        return table.size() * sizeof(uint8_t);
+    }
 private:
     template <typename code_t>
     void generate_table(const code_t G, const size_t R) {
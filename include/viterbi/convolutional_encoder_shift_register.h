@@ -38,6 +38,10 @@ public:
         reg = 0u; 
     }
 
+    size_t get_table_size() const {
+        return G.size() * sizeof(reg_t);
+    }
+
     // Output R bytes for each input byte
     void consume_byte(const uint8_t x, uint8_t* y) override {
         auto& parity_table = ParityTable::get();
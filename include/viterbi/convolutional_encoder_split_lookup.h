@@ -0,0 +1,117 @@
+/* Copyright (c) 2023 William Yang. All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see https://opensource.org/licenses/MIT.
+ */
+#pragma once
+#include "./convolutional_encoder.h"
+#include "./parity_table.h"
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+/// @brief Convolutional encoder that uses a lookup table split into byte sized slices of the register.
+///        The encoder output is linear over GF(2) so the output of the whole register is the
+///        xor of the outputs of each slice when every other slice is zero.
+///        This needs ceil((K+7)/8) tables of 256 entries instead of a single table of 2^(K+7) entries.
+///        For K <= 32 this is at most 5 tables which fit inside the L1 cache.
+class ConvolutionalEncoder_SplitLookup: public ConvolutionalEncoder
+{
+private:
+    static constexpr size_t TOTAL_BITS_INPUT = 8u;
+    static constexpr size_t TOTAL_BITS_SLICE = 8u;
+    static constexpr size_t TOTAL_SLICE_ENTRIES = size_t(1u) << TOTAL_BITS_SLICE;
+    static constexpr size_t TOTAL_BYTES_WORD = sizeof(uint64_t);
+    const size_t TOTAL_BITS_STATE;
+    const size_t TOTAL_BITS_LOOKUP;
+    const size_t TOTAL_SLICES;
+    const size_t TOTAL_WORDS_OUTPUT;
+    const uint64_t LOOKUP_BITMASK;
+    const uint64_t ENCODE_BITMASK;
+private:
+    uint64_t reg = 0u;
+    // Each entry has R output bytes packed into 64bit words
+    std::vector<uint64_t> table;
+    std::vector<uint64_t> out;
+public:
+    template <typename code_t>
+    ConvolutionalEncoder_SplitLookup(const size_t constraint_length, const size_t code_rate, const code_t* G)
+    :   ConvolutionalEncoder(constraint_length, code_rate),
+        TOTAL_BITS_STATE(K-1u),
+        TOTAL_BITS_LOOKUP(TOTAL_BITS_STATE + TOTAL_BITS_INPUT),
+        TOTAL_SLICES((TOTAL_BITS_LOOKUP + TOTAL_BITS_SLICE - 1u) / TOTAL_BITS_SLICE),
+        TOTAL_WORDS_OUTPUT((R + TOTAL_BYTES_WORD - 1u) / TOTAL_BYTES_WORD),
+        LOOKUP_BITMASK((TOTAL_BITS_LOOKUP >= 64u) ? ~uint64_t(0u) : ((uint64_t(1u) << TOTAL_BITS_LOOKUP) - 1u)),
+        ENCODE_BITMASK((uint64_t(1u) << K) - 1u)
+    {
+        assert(K > 1u);
+        assert(R > 1u);
+        assert(TOTAL_BITS_LOOKUP <= 64u);       // register and input byte must fit inside uint64_t
+        table.resize(TOTAL_SLICES * TOTAL_SLICE_ENTRIES * TOTAL_WORDS_OUTPUT);
+        out.resize(TOTAL_WORDS_OUTPUT);
+        generate_table(G);
+        reset();
+    }
+
+    void reset() override {
+        reg = 0u;
+    }
+
+    // Output R bytes for each input byte
+    void consume_byte(const uint8_t x, uint8_t* y) override {
+        reg = ((reg << TOTAL_BITS_INPUT) | uint64_t(x)) & LOOKUP_BITMASK;
+
+        if (TOTAL_WORDS_OUTPUT == 1u) {
+            uint64_t v = 0u;
+            for (size_t s = 0u; s < TOTAL_SLICES; s++) {
+                const size_t i = size_t(reg >> (s*TOTAL_BITS_SLICE)) & (TOTAL_SLICE_ENTRIES-1u);
+                v ^= table[s*TOTAL_SLICE_ENTRIES + i];
+            }
+            for (size_t k = 0u; k < R; k++) {
+                y[k] = uint8_t(v >> (k*8u));
+            }
+            return;
+        }
+
+        for (auto& v: out) {
+            v = 0u;
+        }
+        for (size_t s = 0u; s < TOTAL_SLICES; s++) {
+            const size_t i = size_t(reg >> (s*TOTAL_BITS_SLICE)) & (TOTAL_SLICE_ENTRIES-1u);
+            const uint64_t* v = &table[(s*TOTAL_SLICE_ENTRIES + i)*TOTAL_WORDS_OUTPUT];
+            for (size_t w = 0u; w < TOTAL_WORDS_OUTPUT; w++) {
+                out[w] ^= v[w];
+            }
+        }
+        for (size_t k = 0u; k < R; k++) {
+            y[k] = uint8_t(out[k/TOTAL_BYTES_WORD] >> ((k%TOTAL_BYTES_WORD)*8u));
+        }
+    }
+
+    size_t get_table_size() const {
+        return table.size() * sizeof(uint64_t);
+    }
+private:
+    template <typename code_t>
+    void generate_table(const code_t* G) {
+        auto& parity_table = ParityTable::get();
+
+        for (size_t s = 0u; s < TOTAL_SLICES; s++) {
+            for (size_t i = 0u; i < TOTAL_SLICE_ENTRIES; i++) {
+                uint64_t* y = &table[(s*TOTAL_SLICE_ENTRIES + i)*TOTAL_WORDS_OUTPUT];
+                // Register contents with only this slice set
+                uint64_t x = (uint64_t(i) << (s*TOTAL_BITS_SLICE)) & LOOKUP_BITMASK;
+                size_t curr_bit = 0u;
+                for (size_t j = 0u; j < TOTAL_BITS_INPUT; j++) {
+                    const uint64_t state = (x >> (TOTAL_BITS_INPUT-1u-j)) & ENCODE_BITMASK;
+                    for (size_t k = 0u; k < R; k++) {
+                        const uint64_t code_out = state & uint64_t(G[k]);
+                        const uint64_t bit_out = uint64_t(parity_table.parse<uint64_t>(code_out));
+                        y[curr_bit / 64u] |= (bit_out << (curr_bit % 64u));
+                        curr_bit++;
+                    }
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,138 @@
+/* Copyright (c) 2023 William Yang. All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see https://opensource.org/licenses/MIT.
+ */
+#pragma once
+#include <array>
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+/// @brief Convolutional encoder with a compile time constraint length and code rate.
+///        Encodes 64 input bits at a time by xoring delayed copies of the input word for each generator tap.
+///        Unlike ConvolutionalEncoder this is not virtual, and can emit soft decision symbols directly.
+template <size_t constraint_length, size_t code_rate>
+class ConvolutionalEncoderT
+{
+public:
+    static constexpr size_t K = constraint_length;
+    static constexpr size_t R = code_rate;
+    static constexpr size_t TOTAL_WORD_BITS = 64u;
+    static constexpr size_t TOTAL_STATE_BITS = K-1u;
+    static constexpr uint64_t STATE_MASK = (uint64_t(1) << TOTAL_STATE_BITS) - 1u;
+    static_assert(K > 1u, "Constraint length must be greater than 1");
+    static_assert(R > 1u, "Code rate must be greater than 1");
+    static_assert(K <= TOTAL_WORD_BITS, "Constraint length must fit inside a 64bit word");
+private:
+    std::array<uint64_t, R> G;
+    // Last K-1 input bits where the least significant bit is the most recent bit
+    uint64_t reg = 0u;
+public:
+    template <typename code_t>
+    explicit ConvolutionalEncoderT(const code_t* _G) {
+        const uint64_t CONSTRAINT_MASK = (STATE_MASK << 1u) | uint64_t(1u);
+        for (size_t i = 0u; i < R; i++) {
+            G[i] = uint64_t(_G[i]) & CONSTRAINT_MASK;
+        }
+        reset();
+    }
+
+    /// @brief Resets internal registers of the encoder.
+    void reset(const uint64_t state = 0u) {
+        reg = state & STATE_MASK;
+    }
+
+    uint64_t get_state() const {
+        return reg;
+    }
+
+    /// @brief Encodes the first total_bits of x starting from the most significant bit.
+    ///        Output bits for generator j are written into y[j] with the same bit ordering as x.
+    ///        Bits after total_bits in y are undefined.
+    void encode_word(const uint64_t x, const size_t total_bits, uint64_t* y) {
+        assert(total_bits > 0u);
+        assert(total_bits <= TOTAL_WORD_BITS);
+
+        for (size_t j = 0u; j < R; j++) {
+            y[j] = 0u;
+        }
+
+        for (size_t k = 0u; k < K; k++) {
+            // Input delayed by k bits with the previous input bits shifted in
+            const uint64_t s = (k == 0u) ? x : ((x >> k) | (reg << (TOTAL_WORD_BITS-k)));
+            for (size_t j = 0u; j < R; j++) {
+                const uint64_t tap_mask = uint64_t(0u) - ((G[j] >> k) & uint64_t(1u));
+                y[j] ^= (s & tap_mask);
+            }
+        }
+
+        if (total_bits == TOTAL_WORD_BITS) {
+            reg = x & STATE_MASK;
+        } else {
+            reg = ((reg << total_bits) | (x >> (TOTAL_WORD_BITS-total_bits))) & STATE_MASK;
+        }
+    }
+
+    /// @brief Encodes input bytes into R soft decision symbols per bit.
+    /// @return Number of symbols written which is total_bytes*8*R.
+    template <typename soft_t>
+    size_t encode_block(
+        const uint8_t* x, const size_t total_bytes, soft_t* y,
+        const soft_t soft_decision_high, const soft_t soft_decision_low)
+    {
+        constexpr size_t TOTAL_WORD_BYTES = TOTAL_WORD_BITS/8u;
+        uint64_t out[R];
+        soft_t* y_start = y;
+
+        size_t curr_byte = 0u;
+        for (; (curr_byte + TOTAL_WORD_BYTES) <= total_bytes; curr_byte += TOTAL_WORD_BYTES) {
+            const uint64_t word = load_word(&x[curr_byte], TOTAL_WORD_BYTES);
+            encode_word(word, TOTAL_WORD_BITS, out);
+            y += emit_symbols(out, TOTAL_WORD_BITS, y, soft_decision_high, soft_decision_low);
+        }
+
+        const size_t remain_bytes = total_bytes - curr_byte;
+        if (remain_bytes > 0u) {
+            const uint64_t word = load_word(&x[curr_byte], remain_bytes);
+            encode_word(word, remain_bytes*8u, out);
+            y += emit_symbols(out, remain_bytes*8u, y, soft_decision_high, soft_decision_low);
+        }
+
+        return size_t(y - y_start);
+    }
+
+    /// @brief Flushes K-1 zero bits to terminate the trellis at state 0.
+    /// @return Number of symbols written which is (K-1)*R.
+    template <typename soft_t>
+    size_t encode_tail(soft_t* y, const soft_t soft_decision_high, const soft_t soft_decision_low) {
+        uint64_t out[R];
+        encode_word(0u, TOTAL_STATE_BITS, out);
+        return emit_symbols(out, TOTAL_STATE_BITS, y, soft_decision_high, soft_decision_low);
+    }
+
+    /// @brief Interleaves the output bits of each generator into soft decision symbols.
+    template <typename soft_t>
+    static size_t emit_symbols(
+        const uint64_t* out, const size_t total_bits, soft_t* y,
+        const soft_t soft_decision_high, const soft_t soft_decision_low)
+    {
+        for (size_t i = 0u; i < total_bits; i++) {
+            const size_t shift = TOTAL_WORD_BITS-1u-i;
+            for (size_t j = 0u; j < R; j++) {
+                const bool bit = (out[j] >> shift) & uint64_t(1u);
+                y[j] = bit ? soft_decision_high : soft_decision_low;
+            }
+            y += R;
+        }
+        return total_bits*R;
+    }
+private:
+    // Big endian load so the first input bit is the most significant bit
+    static uint64_t load_word(const uint8_t* x, const size_t total_bytes) {
+        uint64_t word = 0u;
+        for (size_t i = 0u; i < total_bytes; i++) {
+            word |= uint64_t(x[i]) << (TOTAL_WORD_BITS-8u-i*8u);
+        }
+        return word;
+    }
+};
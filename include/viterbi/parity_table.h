@@ -5,6 +5,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 /// @brief Utility class for getting the parity of a primitive's bits
 ///        Odd bits = 1, Even bits = 0
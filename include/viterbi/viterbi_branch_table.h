@@ -4,6 +4,7 @@
  * 
  * Modified by author, William Yang
  * 07/2023 - Refactored branch table into separate class
+ * 10/2026 - Exposed the soft decision values so callers can work out the error of a known symbol value.
  */
 #pragma once
 
@@ -64,6 +65,9 @@ public:
     const soft_t* data() const { 
         return &branch_table[0].buf[0]; 
     }
+
+    soft_t get_soft_decision_high() const { return soft_decision_high; }
+    soft_t get_soft_decision_low() const { return soft_decision_low; }
 private:
     const soft_t soft_decision_high;
     const soft_t soft_decision_low;
@@ -5,17 +5,28 @@
  * Modified by author, William Yang
  * 07/2023 - Consolidated core data structures used for decoding between various viterbi decoders into a single class
  * 07/2023 - Refactored these data structured into cleared individual components
+ * 10/2026 - Added an observer template parameter which is notified on reset and chainback, and by the decoders on each decoded bit.
+ * 10/2026 - Added per frame reliability from the end state margin and ambiguous merges along the traced path.
+ * 10/2026 - Added push_symbols() which buffers partial stages so any number of symbols can be decoded at a time.
+ * 10/2026 - Added snapshots of the decoder state and forking decoders which share the decisions written before the fork.
+ * 10/2026 - Added opt-in pruning of unreachable states and branches in the head and tail of terminated frames.
+ * 10/2026 - Shared decisions are kept as a chain of immutable segments so nested forks don't copy the prefix.
  */
 #pragma once
 #include "./viterbi_branch_table.h"
 #include "./viterbi_decoder_config.h"
+#include "./viterbi_decoder_observer.h"
 #include "./alignment.h"
 
 #include <stdint.h>
 #include <stddef.h>
 #include <stdalign.h>
 #include <vector>
+#include <memory>
 #include <cstring>
+#include <limits>
+#include <utility>
+#include <algorithm>
 #include <assert.h>
 
 /// @brief Stores the error metrics for each state in a double buffer.
@@ -46,6 +57,7 @@ private:
 
 /// @brief Stores the leading bit of the previous state for each current state. 
 ///        The bits are packed into a primitive type, where the lowest order bit corresponds to the first current state.
+///        Decisions before the prefix length can be shared between forked decoders and are never written to.
 template<size_t constraint_length, typename decision_bits_t>
 class ViterbiDecisionBits 
 {
@@ -65,21 +77,105 @@ public:
     static constexpr size_t TOTAL_BLOCKS = get_max(NUMSTATES/TOTAL_BITS_PER_BLOCK, size_t(1));
     static constexpr size_t SIZE_IN_BYTES = TOTAL_BLOCKS*sizeof(format_t);
 public:
-    ViterbiDecisionBits() {}
+    ViterbiDecisionBits(): prefix_length(0) {}
     void resize(const size_t length) { 
-        buffer.resize(length); 
+        assert(length >= prefix_length);
+        buffer.resize(length - prefix_length); 
     }
     size_t size() const { 
-        return buffer.size(); 
+        return prefix_length + buffer.size(); 
     }
+    size_t get_prefix_length() const {
+        return prefix_length;
+    }
+    /// @brief Decisions after the prefix which are owned by us and can be written to
     format_t* operator[](const size_t index) {
-        return &buffer[index].blocks[0];
+        assert(index >= prefix_length);
+        return &buffer[index - prefix_length].blocks[0];
+    }
+    const format_t* operator[](const size_t index) const {
+        if (index < prefix_length) {
+            // Find the last segment starting at or before the index
+            const auto it = std::upper_bound(
+                prefix.begin(), prefix.end(), index, 
+                [](const size_t i, const auto& segment) { return i < segment->offset; }
+            );
+            const auto& segment = *(it-1);
+            return &segment->blocks[index - segment->offset].blocks[0];
+        }
+        return &buffer[index - prefix_length].blocks[0];
+    }
+
+    /// @brief Total number of decisions allocated by the segments of the prefix
+    size_t get_prefix_capacity() const {
+        size_t total = 0;
+        for (const auto& segment: prefix) {
+            total += segment->blocks.capacity();
+        }
+        return total;
+    }
+
+    /// @brief Move the first length decisions into a prefix which can be shared.
+    ///        The prefix is a chain of immutable segments, so extending it only copies the newly frozen decisions 
+    ///        out of our buffer into a new segment and nested forks don't copy the decisions before them.
+    void freeze_prefix(const size_t length) {
+        assert(length >= prefix_length);
+        assert(length <= size());
+        if (length == prefix_length) return;
+        const size_t total_length = size();
+        const size_t total_frozen = length - prefix_length;
+        // Only allocate the frozen range so the segment doesn't hold onto the rest of the traceback
+        auto segment = std::make_shared<segment_t>();
+        segment->offset = prefix_length;
+        segment->blocks.assign(buffer.begin(), buffer.begin() + total_frozen);
+        prefix.push_back(std::move(segment));
+        prefix_length = length;
+        // Decisions after the frozen range haven't been decoded yet so their contents don't need to be kept
+        buffer.resize(total_length - length);
+    }
+
+    /// @brief Use the prefix of other and allocate our own decisions after it
+    void share_prefix(const ViterbiDecisionBits& other) {
+        const size_t total_length = other.size();
+        prefix = other.prefix;
+        prefix_length = other.prefix_length;
+        buffer.resize(total_length - prefix_length);
+    }
+
+    /// @brief Take a private copy of the shared prefix so every decision can be written to again
+    void copy_prefix() {
+        if (prefix.empty()) return;
+        std::vector<blocks_t> new_buffer;
+        new_buffer.reserve(size());
+        for (const auto& segment: prefix) {
+            new_buffer.insert(new_buffer.end(), segment->blocks.begin(), segment->blocks.end());
+        }
+        new_buffer.insert(new_buffer.end(), buffer.begin(), buffer.end());
+        buffer = std::move(new_buffer);
+        prefix.clear();
+        prefix_length = 0;
+    }
+
+    /// @brief Stop using the shared prefix and store all decisions ourselves
+    ///        The decisions in the prefix are discarded
+    void clear_prefix() {
+        if (prefix.empty()) return;
+        const size_t total_length = size();
+        prefix.clear();
+        prefix_length = 0;
+        buffer.resize(total_length);
     }
 private:
     struct blocks_t {
         format_t blocks[TOTAL_BLOCKS];
     };
+    struct segment_t {
+        size_t offset;                  // index of the first decision in this segment
+        std::vector<blocks_t> blocks;
+    };
     std::vector<blocks_t> buffer;
+    std::vector<std::shared_ptr<const segment_t>> prefix;
+    size_t prefix_length;
 };
 
 /// @brief A buffer that is used to shift in the current state of the viterbi decoder as it goes back through the trellis.
@@ -152,9 +248,42 @@ private:
     buffer_t buffer;
 };
 
+/// @brief Quality of a decoded frame which can be used to drop bad frames before further processing.
+template <typename error_t>
+struct ViterbiDecoder_Reliability
+{
+    size_t best_state;              // end state with the lowest error
+    error_t best_error;
+    error_t second_best_error;      // lowest error of the remaining end states
+    size_t total_checked_stages;    // number of stages checked along the traced path
+    size_t total_ambiguous_stages;  // number of those stages whose merge was within the margin threshold
+
+    /// @brief Difference in error between the best and second best end states
+    error_t get_margin() const { return second_best_error - best_error; }
+    /// @brief Yamamoto-Itoh flag where the traced path had a close merge in the checked stages
+    bool is_ambiguous() const { return total_ambiguous_stages > 0; }
+};
+
+/// @brief State that is needed to continue decoding from a stage.
+///        The decisions aren't included since they aren't modified before the saved stage.
+template <size_t constraint_length, size_t code_rate, typename error_t, typename soft_t>
+struct ViterbiDecoder_Snapshot
+{
+    ViterbiErrorMetrics<constraint_length,error_t> metrics;
+    size_t current_decoded_bit = 0;
+    soft_t pending_symbols[code_rate];
+    size_t total_pending_symbols = 0;
+};
+
+/// @brief Befriended by each decoder so its private kernels can be called directly, e.g. by a microbenchmark.
+///        Only declared here, users provide the definition.
+template <class decoder_t>
+struct ViterbiDecoder_KernelAccess;
+
 /// @brief Core data structures for viterbi decoder.
 ///        Traceback technique is the same for all types of viterbi decoders.
-template <size_t constraint_length, size_t code_rate, typename error_t, typename soft_t>
+///        The observer defaults to a no-op, see viterbi_decoder_observer.h for the hooks it must provide.
+template <size_t constraint_length, size_t code_rate, typename error_t, typename soft_t, typename observer_t = ViterbiDecoder_NullObserver>
 class ViterbiDecoder_Core
 {
 public:
@@ -166,9 +295,12 @@ public:
     using Config = ViterbiDecoder_Config<error_t>;
     using Metrics = ViterbiErrorMetrics<K,error_t>;
     using Decisions = ViterbiDecisionBits<K,uintptr_t>;
+    using Observer = observer_t;
+    using Snapshot = ViterbiDecoder_Snapshot<K,R,error_t,soft_t>;
 public:
     ViterbiDecoder_Core(const BranchTable& _branch_table, const Config& _config)
-    :   m_branch_table(_branch_table), m_config(_config), m_decisions()
+    :   m_branch_table(_branch_table), m_config(_config), m_decisions(), m_ambiguities(), m_margin_threshold(0), 
+        m_total_pending_symbols(0), m_terminated_frame_length(0), m_is_head_pruned(false)
     {
         static_assert(K >= 2u);       
         static_assert(R >= 1u);
@@ -191,6 +323,102 @@ public:
         return N - TOTAL_STATE_BITS;
     }
 
+    /// @brief Track merges whose two candidate paths are within the margin threshold over the last total_stages decoded bits.
+    ///        This should be set before decoding a frame. Setting total_stages to 0 disables tracking.
+    ///        The decoders only compute these while tracking is enabled so there is no overhead otherwise.
+    void set_reliability_length(const size_t total_stages, const error_t margin_threshold) {
+        m_ambiguities.resize(total_stages);
+        m_margin_threshold = margin_threshold;
+    }
+
+    /// @brief Returns the number of stages we are tracking merges for
+    size_t get_reliability_length() const {
+        return m_ambiguities.size();
+    }
+
+    error_t get_margin_threshold() const {
+        return m_margin_threshold;
+    }
+
+    /// @brief Decode frames that start in state 0 and end with K-1 zero tail bits after total_data_bits.
+    ///        For the first K-1 stages only 2^t states are reachable, and the tail stages only take zero input branches.
+    ///        The decoders skip these unreachable states and branches, which is a large part of the work for short frames.
+    ///        Setting 0 disables pruning. This should be set before reset(), which marks every other state as unreachable when starting from state 0.
+    ///        Stages aren't pruned while reliability tracking is enabled.
+    void set_terminated_frame_length(const size_t total_data_bits) {
+        // Head and tail stages must not overlap
+        assert((total_data_bits == 0u) || (total_data_bits >= TOTAL_STATE_BITS));
+        m_terminated_frame_length = total_data_bits;
+    }
+
+    /// @brief Returns the number of data bits in a terminated frame or 0 if pruning is disabled
+    size_t get_terminated_frame_length() const {
+        return m_terminated_frame_length;
+    }
+
+    /// @brief Returns true if the decoders should use their pruned butterfly for a decoded bit
+    bool is_pruned_stage(const size_t decoded_bit) const {
+        if (decoded_bit < TOTAL_STATE_BITS) {
+            return m_is_head_pruned;
+        }
+        return 
+            (m_terminated_frame_length > 0u) && 
+            (decoded_bit >= m_terminated_frame_length) && 
+            (decoded_bit < (m_terminated_frame_length + TOTAL_STATE_BITS));
+    }
+
+    /// @brief Error given to pruned states. This leaves room to add the error of one stage without overflowing.
+    error_t get_unreachable_error() const {
+        return error_t(std::numeric_limits<error_t>::max() - m_config.soft_decision_max_error);
+    }
+
+    /// @brief Ambiguous merge bits for a decoded bit which are stored in a ring buffer of the last few stages
+    typename Decisions::format_t* get_ambiguity_bits(const size_t decoded_bit) {
+        assert(m_ambiguities.size() > 0);
+        return m_ambiguities[decoded_bit % m_ambiguities.size()];
+    }
+
+    /// @brief Get the margin between the two best end states.
+    ///        If reliability tracking is enabled then also trace back from the end state
+    ///        and count ambiguous merges along the path in the last tracked stages.
+    ViterbiDecoder_Reliability<error_t> get_reliability(const size_t end_state = 0u) {
+        assert(end_state < NUMSTATES);
+        ViterbiDecoder_Reliability<error_t> res;
+
+        const auto* metrics = m_metrics.get_old();
+        const bool is_first_best = metrics[0] <= metrics[1];
+        res.best_state = is_first_best ? 0u : 1u;
+        res.best_error = is_first_best ? metrics[0] : metrics[1];
+        res.second_best_error = is_first_best ? metrics[1] : metrics[0];
+        for (size_t i = 2u; i < NUMSTATES; i++) {
+            const error_t x = metrics[i];
+            if (x < res.best_error) {
+                res.second_best_error = res.best_error;
+                res.best_error = x;
+                res.best_state = i;
+            } else if (x < res.second_best_error) {
+                res.second_best_error = x;
+            }
+        }
+
+        const size_t total_tracked = m_ambiguities.size();
+        res.total_checked_stages = (m_current_decoded_bit < total_tracked) ? m_current_decoded_bit : total_tracked;
+        res.total_ambiguous_stages = 0u;
+        size_t state = end_state;
+        for (size_t i = 0u; i < res.total_checked_stages; i++) {
+            const size_t curr_decoded_bit = (m_current_decoded_bit-1)-i;
+            const size_t curr_block_index = state / m_decisions.TOTAL_BITS_PER_BLOCK;
+            const size_t curr_block_bit   = state % m_decisions.TOTAL_BITS_PER_BLOCK;
+            const auto* decision_bits = std::as_const(m_decisions)[curr_decoded_bit];
+            const auto* ambiguity_bits = get_ambiguity_bits(curr_decoded_bit);
+            res.total_ambiguous_stages += size_t((ambiguity_bits[curr_block_index] >> curr_block_bit) & 0b1);
+            // Previous state has the decision bit shifted in as its leading bit
+            const size_t input_bit = (decision_bits[curr_block_index] >> curr_block_bit) & 0b1;
+            state = (state >> 1) | (input_bit << (TOTAL_STATE_BITS-1));
+        }
+        return res;
+    }
+
     /// @brief Get the normalised error at a specified end state
     error_t get_error(const size_t end_state = 0u) {
         assert(end_state < Metrics::NUMSTATES);
@@ -201,21 +429,111 @@ public:
     /// @brief Prime the error metrics for a clean decode run
     void reset(const size_t starting_state = 0u) {
         m_current_decoded_bit = 0u;
+        m_total_pending_symbols = 0u;
+        m_decisions.clear_prefix();
+        m_observer.on_reset();
+
+        // Reachable states are only the first 2^t states when starting from state 0
+        constexpr size_t STATE_MASK = Metrics::NUMSTATES-1;
+        m_is_head_pruned = (m_terminated_frame_length > 0u) && ((starting_state & STATE_MASK) == 0u);
 
         auto* old_metrics = m_metrics.get_old();
+        const error_t non_start_error = m_is_head_pruned ? get_unreachable_error() : m_config.initial_non_start_error;
         for (size_t i = 0; i < Metrics::NUMSTATES; i++) {
-            old_metrics[i] = m_config.initial_non_start_error;
+            old_metrics[i] = non_start_error;
         }
-        constexpr size_t STATE_MASK = Metrics::NUMSTATES-1;
         old_metrics[starting_state & STATE_MASK] = m_config.initial_start_error;
     }
 
+    /// @brief Decode any number of symbols using the update() function of decoder_t.
+    ///        Symbols that don't complete a stage are kept until the next call.
+    ///        Full stages are passed to the decoder in a single batch.
+    template <class decoder_t, typename sum_error_t>
+    sum_error_t push_symbols(const soft_t* symbols, size_t N) {
+        sum_error_t total_error = 0;
+        // Complete the partial stage from the previous call
+        if (m_total_pending_symbols > 0u) {
+            const size_t total_missing = R - m_total_pending_symbols;
+            const size_t total_copy = (N < total_missing) ? N : total_missing;
+            std::memcpy(&m_pending_symbols[m_total_pending_symbols], symbols, total_copy*sizeof(soft_t));
+            m_total_pending_symbols += total_copy;
+            symbols += total_copy;
+            N -= total_copy;
+            if (m_total_pending_symbols < R) {
+                return total_error;
+            }
+            total_error += decoder_t::template update<sum_error_t>(*this, m_pending_symbols, R);
+            m_total_pending_symbols = 0u;
+        }
+
+        const size_t total_remainder = N % R;
+        const size_t total_full = N - total_remainder;
+        if (total_full > 0u) {
+            total_error += decoder_t::template update<sum_error_t>(*this, symbols, total_full);
+        }
+        std::memcpy(m_pending_symbols, &symbols[total_full], total_remainder*sizeof(soft_t));
+        m_total_pending_symbols = total_remainder;
+        return total_error;
+    }
+
+    /// @brief Returns the number of symbols kept by push_symbols() that don't complete a stage yet
+    size_t get_total_pending_symbols() const {
+        return m_total_pending_symbols;
+    }
+
+    /// @brief Save the error metrics, current stage and pending symbols
+    void save_snapshot(Snapshot& snapshot) {
+        snapshot.metrics = m_metrics;
+        snapshot.current_decoded_bit = m_current_decoded_bit;
+        std::memcpy(snapshot.pending_symbols, m_pending_symbols, sizeof(m_pending_symbols));
+        snapshot.total_pending_symbols = m_total_pending_symbols;
+    }
+
+    /// @brief Continue decoding from a snapshot of this decoder.
+    ///        The decisions before the snapshot must not have been overwritten since it was saved,
+    ///        which holds as long as the decoder hasn't been reset or restored to an earlier stage.
+    ///        fork_from() freezes the decisions of the parent up to its current stage. Restoring a snapshot 
+    ///        from before a fork copies the shared decisions back into this decoder, which costs a copy of the frame.
+    void restore_snapshot(const Snapshot& snapshot) {
+        assert(snapshot.current_decoded_bit <= m_decisions.size());
+        // Decoding would overwrite decisions shared with forked decoders
+        if (snapshot.current_decoded_bit < m_decisions.get_prefix_length()) {
+            m_decisions.copy_prefix();
+        }
+        m_metrics = snapshot.metrics;
+        m_current_decoded_bit = snapshot.current_decoded_bit;
+        std::memcpy(m_pending_symbols, snapshot.pending_symbols, sizeof(m_pending_symbols));
+        m_total_pending_symbols = snapshot.total_pending_symbols;
+    }
+
+    /// @brief Continue decoding from the current stage of another decoder with the same branch table and config.
+    ///        Decisions written before the fork are shared instead of copied, so many decoders can be forked
+    ///        from a common prefix to try different hypotheses for the rest of the frame.
+    ///        Both decoders can keep decoding independently after the fork.
+    ///        The decisions of the parent up to its current stage become read only, so restoring the parent
+    ///        to a snapshot from before the fork has to copy them back first. See restore_snapshot().
+    void fork_from(ViterbiDecoder_Core& parent) {
+        assert(&m_branch_table == &parent.m_branch_table);
+        assert(this != &parent);
+        parent.m_decisions.freeze_prefix(parent.m_current_decoded_bit);
+        m_decisions.share_prefix(parent.m_decisions);
+        m_ambiguities = parent.m_ambiguities;
+        m_margin_threshold = parent.m_margin_threshold;
+        m_terminated_frame_length = parent.m_terminated_frame_length;
+        m_is_head_pruned = parent.m_is_head_pruned;
+        m_metrics = parent.m_metrics;
+        m_current_decoded_bit = parent.m_current_decoded_bit;
+        std::memcpy(m_pending_symbols, parent.m_pending_symbols, sizeof(m_pending_symbols));
+        m_total_pending_symbols = parent.m_total_pending_symbols;
+    }
+
     /// @brief Writes the decoded bytes into the given array
     void chainback(uint8_t* bytes_out, const size_t total_bits, const size_t end_state = 0u) {
         const size_t traceback_length = get_traceback_length();
         assert(traceback_length >= total_bits);
         assert((m_current_decoded_bit - TOTAL_STATE_BITS) >= total_bits);
         assert(end_state < NUMSTATES);
+        m_observer.on_chainback(total_bits);
 
         ViterbiTracebackBuffer<K> decode_buffer;
         decode_buffer.set_state(end_state);
@@ -224,7 +542,7 @@ public:
             const size_t j = (total_bits-1)-i;
             const size_t curr_decoded_byte = j/8;
             const size_t curr_decision = j + TOTAL_STATE_BITS;
-            auto* decision_bits = m_decisions[curr_decision];
+            const auto* decision_bits = std::as_const(m_decisions)[curr_decision];
 
             const size_t state = decode_buffer.get_state();
             const size_t curr_block_index = state / m_decisions.TOTAL_BITS_PER_BLOCK;
@@ -239,5 +557,12 @@ public:
     const Config m_config;
     Metrics m_metrics;
     Decisions m_decisions;
+    Decisions m_ambiguities;
+    error_t m_margin_threshold;
     size_t m_current_decoded_bit;
+    Observer m_observer;
+    soft_t m_pending_symbols[R];
+    size_t m_total_pending_symbols;
+    size_t m_terminated_frame_length;
+    bool m_is_head_pruned;
 };
\ No newline at end of file
@@ -0,0 +1,99 @@
+/* Copyright (c) 2023 William Yang. All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see https://opensource.org/licenses/MIT.
+ */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <limits>
+
+// Observers are passed as a template parameter to the viterbi decoder core and the decoders.
+// The decoders call these hooks from their update loop and the core calls them on reset and chainback.
+// An observer must provide all of the following member functions:
+//     void on_reset();
+//     template <typename error_t> void on_stage(const error_t* metrics, const size_t total_states);
+//     template <typename error_t> void on_renormalise(const error_t min_error);
+//     void on_chainback(const size_t total_bits);
+// on_stage() receives the new error metrics of each decoded bit before they are renormalised.
+
+/// @brief Default observer with empty hooks so the decoders compile to the same code as without an observer.
+struct ViterbiDecoder_NullObserver
+{
+    inline void on_reset() {}
+    template <typename error_t>
+    inline void on_stage(const error_t* /*metrics*/, const size_t /*total_states*/) {}
+    template <typename error_t>
+    inline void on_renormalise(const error_t /*min_error*/) {}
+    inline void on_chainback(const size_t /*total_bits*/) {}
+};
+
+/// @brief Counts events that show the health of a decoder in production.
+///        Metrics that reach the maximum of the error type are counted as saturated.
+///        The decoders use saturating adds so a saturated metric means the renormalisation threshold is too high
+///        and the decoder is losing information.
+///        on_stage() scans the metrics of every state at every decoded bit with scalar code,
+///        so this observer is far from free and can cost more than the vectorised butterflies it is watching.
+class ViterbiDecoder_HealthObserver
+{
+public:
+    uint64_t total_resets = 0;
+    uint64_t total_stages = 0;
+    uint64_t total_renormalisations = 0;
+    uint64_t total_renormalisation_error = 0;
+    uint64_t max_renormalisation_error = 0;
+    uint64_t max_metric_spread = 0;
+    uint64_t total_metric_spread = 0;
+    uint64_t total_saturated_stages = 0;
+    uint64_t total_saturated_metrics = 0;
+    uint64_t total_chainbacks = 0;
+    uint64_t total_chainback_bits = 0;
+    uint64_t max_chainback_bits = 0;
+public:
+    inline void on_reset() {
+        total_resets++;
+    }
+
+    template <typename error_t>
+    inline void on_stage(const error_t* metrics, const size_t total_states) {
+        constexpr error_t SATURATED = std::numeric_limits<error_t>::max();
+        error_t min_error = metrics[0];
+        error_t max_error = metrics[0];
+        size_t total_saturated = 0;
+        for (size_t i = 0; i < total_states; i++) {
+            const error_t x = metrics[i];
+            min_error = (x < min_error) ? x : min_error;
+            max_error = (x > max_error) ? x : max_error;
+            total_saturated += (x == SATURATED) ? 1 : 0;
+        }
+        const uint64_t spread = uint64_t(max_error - min_error);
+        total_stages++;
+        total_metric_spread += spread;
+        max_metric_spread = (spread > max_metric_spread) ? spread : max_metric_spread;
+        total_saturated_metrics += uint64_t(total_saturated);
+        total_saturated_stages += (total_saturated > 0) ? 1 : 0;
+    }
+
+    template <typename error_t>
+    inline void on_renormalise(const error_t min_error) {
+        const uint64_t x = uint64_t(min_error);
+        total_renormalisations++;
+        total_renormalisation_error += x;
+        max_renormalisation_error = (x > max_renormalisation_error) ? x : max_renormalisation_error;
+    }
+
+    inline void on_chainback(const size_t total_bits) {
+        const uint64_t x = uint64_t(total_bits);
+        total_chainbacks++;
+        total_chainback_bits += x;
+        max_chainback_bits = (x > max_chainback_bits) ? x : max_chainback_bits;
+    }
+
+    double get_mean_metric_spread() const {
+        if (total_stages == 0) return 0.0;
+        return double(total_metric_spread) / double(total_stages);
+    }
+
+    void clear() {
+        *this = ViterbiDecoder_HealthObserver();
+    }
+};
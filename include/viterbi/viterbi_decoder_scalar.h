@@ -5,19 +5,26 @@
  * Modified by author, William Yang
  * 07/2023 - Generalised the viterbi decoding algorithm for all constraint lengths and code rates as scalar code.
  *           This was done by inspecting the algorithm used in viterbi27_port.c, viterbi29_port.c, viterbi615_port.c.
+ * 10/2026 - Moved update() out of the class body so it can be explicitly instantiated by the precompiled library.
+ * 10/2026 - Befriended ViterbiDecoder_KernelAccess so bfly() and renormalise() can be benchmarked in isolation.
+ * 10/2026 - Added observer template parameter which is notified of each decoded bit and renormalisation.
+ * 10/2026 - Optionally flag merges within a margin threshold as ambiguous for the reliability check.
+ * 10/2026 - Added a pruned butterfly that only visits reachable states in the head and tail of terminated frames.
+ * 10/2026 - Saturate the path metrics and break ties like the intrinsics implementations so they are bit exact.
  */
 #pragma once
 #include "./viterbi_decoder_core.h"
 #include <stdint.h>
 #include <stddef.h>
 #include <vector>
+#include <limits>
 #include <assert.h>
  
-template <size_t constraint_length, size_t code_rate, typename error_t, typename soft_t>
+template <size_t constraint_length, size_t code_rate, typename error_t, typename soft_t, typename observer_t = ViterbiDecoder_NullObserver>
 class ViterbiDecoder_Scalar
 {
 public:
-    using Base = ViterbiDecoder_Core<constraint_length,code_rate,error_t,soft_t>;    
+    using Base = ViterbiDecoder_Core<constraint_length,code_rate,error_t,soft_t,observer_t>;
 private:
     using decision_bits_t = typename Base::Decisions::format_t;
     static constexpr size_t K_min = 2;
@@ -26,39 +33,23 @@ public:
 
     /// @brief Given the output symbols of a convolutional code, start determining the lowest error trajectories through the trellis.
     template <typename sum_error_t>
-    static sum_error_t update(Base& base, const soft_t* symbols, const size_t N) {
-        // NOTE: We expect the symbol values to be in the range set by the branch_table
-        //       symbols[i] ∈ [soft_decision_low, soft_decision_high]
-        //       Otherwise when we calculate inside bfly(...):
-        //           m_total_error = soft_decision_max_error - total_error
-        //       The resulting value could underflow with unsigned error types 
-        // number of symbols must be a multiple of the code rate
-        static_assert(is_valid, "Scalar decoder must have constraint length of at least 2");
-        assert(N % Base::R == 0);
-        const size_t total_decoded_bits = N / Base::R;
-        const size_t max_decoded_bits = base.get_traceback_length() + Base::TOTAL_STATE_BITS;
-        assert((total_decoded_bits + base.m_current_decoded_bit) <= max_decoded_bits);
-
-        sum_error_t total_error = 0;
-        for (size_t i = 0u; i < N; i+=(Base::R)) {
-            auto* decision = base.m_decisions[base.m_current_decoded_bit];
-            auto* old_metric = base.m_metrics.get_old();
-            auto* new_metric = base.m_metrics.get_new();
-            bfly(base, &symbols[i], decision, old_metric, new_metric);
-            if (new_metric[0] >= base.m_config.renormalisation_threshold) {
-                total_error += sum_error_t(renormalise(new_metric));
-            }
-            base.m_metrics.swap();
-            base.m_current_decoded_bit++;
-        }
-        return total_error;
-    }
+    static sum_error_t update(Base& base, const soft_t* symbols, const size_t N);
 private:
+    template <class> friend struct ViterbiDecoder_KernelAccess;
+
     /// @brief Process R symbols and output 1 decoded bit
-    static void bfly(Base& base, const soft_t* symbols, decision_bits_t* decision, error_t* old_metric, error_t* new_metric) {
+    ///        If is_reliability is set then merges within the margin threshold are flagged in the ambiguity bits
+    template <bool is_reliability = false>
+    static void bfly(
+        Base& base, const soft_t* symbols, decision_bits_t* decision, error_t* old_metric, error_t* new_metric, 
+        decision_bits_t* ambiguity = nullptr
+    ) {
         // Guarantee that the decision bits are zeroed out before ORing in our bits
         for (size_t i = 0; i < Base::Decisions::TOTAL_BLOCKS; i++) {
             decision[i] = 0;
+            if constexpr(is_reliability) {
+                ambiguity[i] = 0;
+            }
         }
 
         for (size_t curr_state = 0u; curr_state < Base::BranchTable::NUMSTATES; curr_state++) {
@@ -110,18 +101,16 @@ private:
             // s = input bit
             // g = parity bit corresponding to output symbol
             //  next_error_r_s = r^s^g
-            const error_t next_error_0_0 = old_metric[curr_state_0] + total_error;
-            const error_t next_error_1_0 = old_metric[curr_state_1] + inverted_error;
-            const error_t next_error_0_1 = old_metric[curr_state_0] + inverted_error;
-            const error_t next_error_1_1 = old_metric[curr_state_1] + total_error;
-            // TODO: When adding our error metrics we may cause an overflow to happen 
-            //       if the renormalisation step was not performed in time
-            //       Our intrinsics implementations use saturated arithmetic to prevent an overflow
-            //       Perhaps it is possible to use something like GCC's builtin saturated add here?
+            // Saturate like our intrinsics implementations in case the renormalisation step was not performed in time
+            const error_t next_error_0_0 = add_saturate(old_metric[curr_state_0], total_error);
+            const error_t next_error_1_0 = add_saturate(old_metric[curr_state_1], inverted_error);
+            const error_t next_error_0_1 = add_saturate(old_metric[curr_state_0], inverted_error);
+            const error_t next_error_1_1 = add_saturate(old_metric[curr_state_1], total_error);
 
             // Select the previous state r with a lower error for an input bit s
-            const decision_bits_t decision_0 = next_error_0_0 > next_error_1_0;
-            const decision_bits_t decision_1 = next_error_0_1 > next_error_1_1;
+            // Ties go to r=1 which is what our intrinsics implementations pick
+            const decision_bits_t decision_0 = next_error_0_0 >= next_error_1_0;
+            const decision_bits_t decision_1 = next_error_0_1 >= next_error_1_1;
 
             // Update metrics
             new_metric[next_state_0] = decision_0 ? next_error_1_0 : next_error_0_0;
@@ -132,9 +121,76 @@ private:
             const size_t curr_pack_index = next_state_0 / Base::Decisions::TOTAL_BITS_PER_BLOCK;
             const size_t curr_pack_bit   = next_state_0 % Base::Decisions::TOTAL_BITS_PER_BLOCK;
             decision[curr_pack_index] |= (bits << curr_pack_bit);
+
+            if constexpr(is_reliability) {
+                const error_t threshold = base.get_margin_threshold();
+                const error_t margin_0 = decision_0 ? error_t(next_error_0_0 - next_error_1_0) : error_t(next_error_1_0 - next_error_0_0);
+                const error_t margin_1 = decision_1 ? error_t(next_error_0_1 - next_error_1_1) : error_t(next_error_1_1 - next_error_0_1);
+                const decision_bits_t ambiguous_bits = decision_bits_t(margin_0 <= threshold) | (decision_bits_t(margin_1 <= threshold) << 1);
+                ambiguity[curr_pack_index] |= (ambiguous_bits << curr_pack_bit);
+            }
         }
     }
 
+    /// @brief Process R symbols for a head or tail stage of a terminated frame.
+    ///        Head stage t only has the first 2^t states reachable from state 0.
+    ///        Tail stage j only takes the zero input branch from states whose lower j bits are zero.
+    ///        Every other state is given the unreachable error so it can't win a later merge.
+    static void bfly_pruned(
+        Base& base, const soft_t* symbols, decision_bits_t* decision, error_t* old_metric, error_t* new_metric,
+        const size_t decoded_bit
+    ) {
+        for (size_t i = 0; i < Base::Decisions::TOTAL_BLOCKS; i++) {
+            decision[i] = 0;
+        }
+        const error_t unreachable_error = base.get_unreachable_error();
+        for (size_t i = 0; i < Base::Metrics::NUMSTATES; i++) {
+            new_metric[i] = unreachable_error;
+        }
+
+        const bool is_head = decoded_bit < Base::TOTAL_STATE_BITS;
+        const size_t total_reachable_states = size_t(1u) << decoded_bit;
+        const size_t total_states = (is_head && total_reachable_states < Base::BranchTable::NUMSTATES) ? 
+            total_reachable_states : Base::BranchTable::NUMSTATES;
+        const size_t curr_state_step = is_head ? 1u : (size_t(1u) << (decoded_bit - base.get_terminated_frame_length()));
+
+        for (size_t curr_state = 0u; curr_state < total_states; curr_state += curr_state_step) {
+            error_t total_error = 0u;
+            for (size_t i = 0; i < Base::R; i++) {
+                const soft_t error = base.m_branch_table[i][curr_state] - symbols[i];
+                total_error += error_t(get_abs(error));
+            }
+            const error_t inverted_error = base.m_config.soft_decision_max_error - total_error;
+
+            // Same butterfly as bfly() where the input bit 1 branch is skipped for the tail
+            const size_t curr_state_0 = curr_state;
+            const size_t curr_state_1 = curr_state + Base::Metrics::NUMSTATES/2;
+            const size_t next_state_0 = (curr_state << 1) | 0;
+            const size_t next_state_1 = (curr_state << 1) | 1;
+            const size_t curr_pack_index = next_state_0 / Base::Decisions::TOTAL_BITS_PER_BLOCK;
+            const size_t curr_pack_bit   = next_state_0 % Base::Decisions::TOTAL_BITS_PER_BLOCK;
+
+            const error_t next_error_0_0 = add_saturate(old_metric[curr_state_0], total_error);
+            const error_t next_error_1_0 = add_saturate(old_metric[curr_state_1], inverted_error);
+            const decision_bits_t decision_0 = next_error_0_0 >= next_error_1_0;
+            new_metric[next_state_0] = decision_0 ? next_error_1_0 : next_error_0_0;
+            decision[curr_pack_index] |= (decision_0 << curr_pack_bit);
+            if (!is_head) continue;
+
+            const error_t next_error_0_1 = add_saturate(old_metric[curr_state_0], inverted_error);
+            const error_t next_error_1_1 = add_saturate(old_metric[curr_state_1], total_error);
+            const decision_bits_t decision_1 = next_error_0_1 >= next_error_1_1;
+            new_metric[next_state_1] = decision_1 ? next_error_1_1 : next_error_0_1;
+            decision[curr_pack_index] |= (decision_1 << (curr_pack_bit+1));
+        }
+    }
+
+    /// @brief Unsigned add that clamps to the numeric upper bound of the error type instead of wrapping around
+    static inline error_t add_saturate(const error_t a, const error_t b) {
+        const error_t sum = error_t(a + b);
+        return (sum < a) ? std::numeric_limits<error_t>::max() : sum;
+    }
+
     /// @brief Normalise error metrics so minimum value is the numeric lower bound of the error type 
     static error_t renormalise(error_t* metric) {
         error_t min = metric[0];
@@ -151,10 +207,60 @@ private:
 
         return min;
     }
-
+private:
     template <typename T>
     inline static
     T get_abs(T x) {
         return (x > 0) ? x : -x;
     }
-};
\ No newline at end of file
+};
+
+template <size_t constraint_length, size_t code_rate, typename error_t, typename soft_t, typename observer_t>
+template <typename sum_error_t>
+sum_error_t ViterbiDecoder_Scalar<constraint_length,code_rate,error_t,soft_t,observer_t>::update(Base& base, const soft_t* symbols, const size_t N) {
+    // NOTE: We expect the symbol values to be in the range set by the branch_table
+    //       symbols[i] ∈ [soft_decision_low, soft_decision_high]
+    //       Otherwise when we calculate inside bfly(...):
+    //           m_total_error = soft_decision_max_error - total_error
+    //       The resulting value could underflow with unsigned error types 
+    // number of symbols must be a multiple of the code rate
+    static_assert(is_valid, "Scalar decoder must have constraint length of at least 2");
+    assert(N % Base::R == 0);
+    const size_t total_decoded_bits = N / Base::R;
+    const size_t max_decoded_bits = base.get_traceback_length() + Base::TOTAL_STATE_BITS;
+    assert((total_decoded_bits + base.m_current_decoded_bit) <= max_decoded_bits);
+
+    sum_error_t total_error = 0;
+    for (size_t i = 0u; i < N; i+=(Base::R)) {
+        auto* decision = base.m_decisions[base.m_current_decoded_bit];
+        auto* old_metric = base.m_metrics.get_old();
+        auto* new_metric = base.m_metrics.get_new();
+        if (base.get_reliability_length() > 0) {
+            auto* ambiguity = base.get_ambiguity_bits(base.m_current_decoded_bit);
+            bfly<true>(base, &symbols[i], decision, old_metric, new_metric, ambiguity);
+        } else if (base.is_pruned_stage(base.m_current_decoded_bit)) {
+            bfly_pruned(base, &symbols[i], decision, old_metric, new_metric, base.m_current_decoded_bit);
+        } else {
+            bfly(base, &symbols[i], decision, old_metric, new_metric);
+        }
+        base.m_observer.on_stage(new_metric, Base::NUMSTATES);
+        if (new_metric[0] >= base.m_config.renormalisation_threshold) {
+            const auto min_error = renormalise(new_metric);
+            base.m_observer.on_renormalise(min_error);
+            total_error += sum_error_t(min_error);
+        }
+        base.m_metrics.swap();
+        base.m_current_decoded_bit++;
+    }
+    return total_error;
+}
+
+#if defined(VITERBI_PRECOMPILED)
+#include "./viterbi_precompiled.h"
+#define __VITERBI_EXTERN_SCALAR_U16(K,R) VITERBI_PRECOMPILED_INSTANTIATE(extern, K, R, uint16_t, int16_t, ViterbiDecoder_Scalar<K,R,uint16_t,int16_t>)
+#define __VITERBI_EXTERN_SCALAR_U8(K,R)  VITERBI_PRECOMPILED_INSTANTIATE(extern, K, R, uint8_t,  int8_t,  ViterbiDecoder_Scalar<K,R,uint8_t,int8_t>)
+VITERBI_PRECOMPILED_CODES_K_MIN_2(__VITERBI_EXTERN_SCALAR_U16)
+VITERBI_PRECOMPILED_CODES_K_MIN_2(__VITERBI_EXTERN_SCALAR_U8)
+#undef __VITERBI_EXTERN_SCALAR_U16
+#undef __VITERBI_EXTERN_SCALAR_U8
+#endif
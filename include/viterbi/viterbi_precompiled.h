@@ -0,0 +1,54 @@
+/* Copyright (c) 2023 William Yang. All rights reserved.
+ * This work is licensed under the terms of the MIT license.  
+ * For a copy, see https://opensource.org/licenses/MIT.
+ */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Constraint lengths and code rates of the common codes that are compiled into the viterbi_precompiled library.
+// Vectorised decoders have a minimum constraint length (K_min) so the list is split on that boundary.
+// | Name             |  K  R |
+// | Basic K=3 R=1/2  |  3  2 |
+// | Basic K=5 R=1/2  |  5  2 |
+// | Voyager          |  7  2 |
+// | LTE              |  7  3 |
+// | DAB Radio        |  7  4 |
+// | CDMA IS-95A      |  9  2 |
+// | CDMA 2000        |  9  4 |
+// | Cassini          | 15  6 |
+#define VITERBI_PRECOMPILED_CODES_K_MIN_7(X) X(7,2) X(7,3) X(7,4) X(9,2) X(9,4) X(15,6)
+#define VITERBI_PRECOMPILED_CODES_K_MIN_6(X) VITERBI_PRECOMPILED_CODES_K_MIN_7(X)
+#define VITERBI_PRECOMPILED_CODES_K_MIN_5(X) X(5,2) VITERBI_PRECOMPILED_CODES_K_MIN_6(X)
+#define VITERBI_PRECOMPILED_CODES_K_MIN_2(X) X(3,2) VITERBI_PRECOMPILED_CODES_K_MIN_5(X)
+// Constraint lengths of the common codes for data structures that don't depend on the code rate
+#define VITERBI_PRECOMPILED_CONSTRAINT_LENGTHS(X) X(3) X(5) X(7) X(9) X(15)
+
+// Explicit instantiation of a decoder and its update function for uint64_t error sums.
+// PREFIX is "extern" when declaring the instantiation in a header so consumers link against the precompiled kernel.
+// PREFIX is empty when defining the instantiation inside the library.
+// The decoder is passed last since its template argument list contains commas.
+#define VITERBI_PRECOMPILED_INSTANTIATE(PREFIX, K, R, error_t, soft_t, ...) \
+    PREFIX template class __VA_ARGS__;\
+    PREFIX template uint64_t __VA_ARGS__::update<uint64_t>(ViterbiDecoder_Core<K,R,error_t,soft_t>&, const soft_t*, const size_t);
+
+// Explicit instantiation of the data structures shared by the decoders of every instruction set.
+// These are defined only in the scalar translation unit and declared extern in the vectorised translation units.
+// Otherwise the vectorised translation units, which are compiled with -msse4.2 or -mavx2, emit weak copies of 
+// the non-inlined members and the linker can pick those for code that only runs the scalar decoder.
+#define VITERBI_PRECOMPILED_INSTANTIATE_CORE(PREFIX, K, R, error_t, soft_t) \
+    PREFIX template class ViterbiBranchTable<K,R,soft_t>;\
+    PREFIX template class ViterbiDecoder_Core<K,R,error_t,soft_t>;
+#define VITERBI_PRECOMPILED_INSTANTIATE_CORE_K(PREFIX, K) \
+    PREFIX template class ViterbiErrorMetrics<K,uint16_t>;\
+    PREFIX template class ViterbiErrorMetrics<K,uint8_t>;\
+    PREFIX template class ViterbiDecisionBits<K,uintptr_t>;
+
+// Declare every shared instantiation as extern inside a vectorised translation unit
+#define __VITERBI_EXTERN_CORE_U16(K,R) VITERBI_PRECOMPILED_INSTANTIATE_CORE(extern, K, R, uint16_t, int16_t)
+#define __VITERBI_EXTERN_CORE_U8(K,R)  VITERBI_PRECOMPILED_INSTANTIATE_CORE(extern, K, R, uint8_t,  int8_t)
+#define __VITERBI_EXTERN_CORE_K(K)     VITERBI_PRECOMPILED_INSTANTIATE_CORE_K(extern, K)
+#define VITERBI_PRECOMPILED_EXTERN_CORE() \
+    VITERBI_PRECOMPILED_CODES_K_MIN_2(__VITERBI_EXTERN_CORE_U16)\
+    VITERBI_PRECOMPILED_CODES_K_MIN_2(__VITERBI_EXTERN_CORE_U8)\
+    VITERBI_PRECOMPILED_CONSTRAINT_LENGTHS(__VITERBI_EXTERN_CORE_K)
@@ -0,0 +1,32 @@
+/* Copyright (c) 2023 William Yang. All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see https://opensource.org/licenses/MIT.
+ */
+#pragma once
+#include "../convolutional_encoder_clmul.h"
+#include <stdint.h>
+#include <immintrin.h>
+#include <wmmintrin.h>
+
+struct CLMUL_PCLMUL {
+    static inline void multiply(const uint64_t a, const uint64_t b, uint64_t& lo, uint64_t& hi) {
+        // NOTE: Avoid 64bit register moves so this also compiles for 32bit x86
+        const __m128i A = _mm_set_epi64x(0, int64_t(a));
+        const __m128i B = _mm_set_epi64x(0, int64_t(b));
+        const __m128i P = _mm_clmulepi64_si128(A, B, 0x00);
+        alignas(16) uint64_t v[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(v), P);
+        lo = v[0];
+        hi = v[1];
+    }
+
+    static inline uint64_t reverse_byte_bits(uint64_t x) {
+        x = ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+        x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+        return x;
+    }
+};
+
+/// @brief Carry-less multiply encoder using PCLMULQDQ.
+using ConvolutionalEncoder_PCLMUL = ConvolutionalEncoder_CLMUL<CLMUL_PCLMUL>;
@@ -4,6 +4,11 @@
  * 
  * Modified by author, William Yang
  * 07/2023 - Generalised decoder using AVX2 instructions for 16bit types giving 16 way speedup.
+ * 10/2026 - Moved update() out of the class body so it can be explicitly instantiated by the precompiled library.
+ * 10/2026 - Befriended ViterbiDecoder_KernelAccess so bfly() and renormalise() can be benchmarked in isolation.
+ * 10/2026 - Added observer template parameter which is notified of each decoded bit and renormalisation.
+ * 10/2026 - Optionally flag merges within a margin threshold as ambiguous for the reliability check.
+ * 10/2026 - Skip unreachable blocks of states and the input bit 1 branch in the head and tail of terminated frames.
  */
 #pragma once
 #include "../viterbi_decoder_core.h"
@@ -17,11 +22,11 @@
 /// @brief Vectorisation using AVX2.
 ///        16bit integers for errors, soft-decision values.
 ///        16 way vectorisation from 256bits/16bits.
-template <size_t constraint_length, size_t code_rate>
+template <size_t constraint_length, size_t code_rate, typename observer_t = ViterbiDecoder_NullObserver>
 class ViterbiDecoder_AVX_u16
 {
 private:
-    using Base = ViterbiDecoder_Core<constraint_length,code_rate,uint16_t,int16_t>;
+    using Base = ViterbiDecoder_Core<constraint_length,code_rate,uint16_t,int16_t,observer_t>;
     using decision_bits_t = typename Base::Decisions::format_t;
 private:
     // Calculate the minimum constraint length for vectorisation
@@ -44,37 +49,20 @@ public:
     static constexpr bool is_valid = Base::K >= K_min;
 
     template <typename sum_error_t>
-    static sum_error_t update(Base& base, const int16_t* symbols, const size_t N) {
-        static_assert(is_valid, "Insufficient constraint length for vectorisation");
-        static_assert(Base::Metrics::ALIGNMENT % SIMD_ALIGN == 0);
-        static_assert(Base::BranchTable::ALIGNMENT % SIMD_ALIGN == 0);
-
-        // number of symbols must be a multiple of the code rate
-        assert(N % Base::R == 0);
-        const size_t total_decoded_bits = N / Base::R;
-        const size_t max_decoded_bits = base.get_traceback_length() + Base::TOTAL_STATE_BITS;
-        assert((total_decoded_bits + base.m_current_decoded_bit) <= max_decoded_bits);
-
-        sum_error_t total_error = 0;
-        for (size_t s = 0; s < N; s+=Base::R) {
-            auto* decision = base.m_decisions[base.m_current_decoded_bit];
-            auto* old_metric = base.m_metrics.get_old();
-            auto* new_metric = base.m_metrics.get_new();
-            bfly(base, &symbols[s], decision, old_metric, new_metric);
-            if (new_metric[0] >= base.m_config.renormalisation_threshold) {
-                total_error += sum_error_t(renormalise(new_metric));
-            }
-            base.m_metrics.swap();
-            base.m_current_decoded_bit++;
-        }
-        return total_error;
-    }
+    static sum_error_t update(Base& base, const int16_t* symbols, const size_t N);
 private:
-    static void bfly(Base& base, const int16_t* symbols, decision_bits_t* decision, uint16_t* old_metric, uint16_t* new_metric) {
+    template <class> friend struct ViterbiDecoder_KernelAccess;
+
+    template <bool is_reliability = false, bool is_zero_input = false>
+    static void bfly(
+        Base& base, const int16_t* symbols, decision_bits_t* decision, uint16_t* old_metric, uint16_t* new_metric, 
+        decision_bits_t* ambiguity = nullptr, const size_t total_blocks = v_stride_branch_table
+    ) {
         const __m256i* v_branch_table = reinterpret_cast<const __m256i*>(base.m_branch_table.data());
         __m256i* v_old_metrics = reinterpret_cast<__m256i*>(old_metric);
         __m256i* v_new_metrics = reinterpret_cast<__m256i*>(new_metric);
         uint32_t* v_decision = reinterpret_cast<uint32_t*>(decision);
+        [[maybe_unused]] uint32_t* v_ambiguity = reinterpret_cast<uint32_t*>(ambiguity);
 
         assert(uintptr_t(v_branch_table) % SIMD_ALIGN == 0);
         assert(uintptr_t(v_old_metrics)  % SIMD_ALIGN == 0);
@@ -87,8 +75,10 @@ private:
             v_symbols[i] = _mm256_set1_epi16(symbols[i]);
         }
         const __m256i max_error = _mm256_set1_epi16(base.m_config.soft_decision_max_error);
+        [[maybe_unused]] const __m256i margin_threshold = _mm256_set1_epi16(base.get_margin_threshold());
+        [[maybe_unused]] const __m256i unreachable_error = _mm256_set1_epi16(base.get_unreachable_error());
 
-        for (size_t curr_state = 0u; curr_state < v_stride_branch_table; curr_state++) {
+        for (size_t curr_state = 0u; curr_state < total_blocks; curr_state++) {
             // Total errors across R symbols
             __m256i total_error = _mm256_set1_epi16(0);
             for (size_t i = 0u; i < Base::R; i++) {
@@ -110,9 +100,9 @@ private:
             const __m256i next_error_1_1 = _mm256_adds_epu16(v_old_metrics[curr_state_1],   total_error);
 
             const __m256i min_next_error_0 = _mm256_min_epu16(next_error_0_0, next_error_1_0);
-            const __m256i min_next_error_1 = _mm256_min_epu16(next_error_0_1, next_error_1_1);
+            const __m256i min_next_error_1 = is_zero_input ? unreachable_error : _mm256_min_epu16(next_error_0_1, next_error_1_1);
             const __m256i decision_0 = _mm256_cmpeq_epi16(min_next_error_0, next_error_1_0);
-            const __m256i decision_1 = _mm256_cmpeq_epi16(min_next_error_1, next_error_1_1);
+            const __m256i decision_1 = is_zero_input ? _mm256_setzero_si256() : _mm256_cmpeq_epi16(min_next_error_1, next_error_1_1);
 
             // Update metrics
             const __m256i new_metric_lo = _mm256_unpacklo_epi16(min_next_error_0, min_next_error_1);
@@ -121,17 +111,44 @@ private:
             v_new_metrics[next_state_0] = _mm256_permute2x128_si256(new_metric_lo, new_metric_hi, 0b0010'0000);
             v_new_metrics[next_state_1] = _mm256_permute2x128_si256(new_metric_lo, new_metric_hi, 0b0011'0001);
 
-            // Pack each set of decisions into 8 8-bit bytes, then interleave them and compress into 16 bits
-            // 256bit packs works with 128bit segments
-            // 256bit unpack works with 128bit segments
-            // | = 128bit boundary
-            // packs_16  : d0 .... 0 .... | d1 .... 0 ....
-            // packs_16  : d2 .... 0 .... | d3 .... 0 ....
-            // unpacklo_8: d0 d2 d0 d2 .. | d1 d3 d1 d3 ..
-            // movemask_8: b0 b2 b0 b2 .. | b1 b3 b1 b3 ..
-            v_decision[curr_state] = _mm256_movemask_epi8(_mm256_unpacklo_epi8(
-                _mm256_packs_epi16(decision_0, _mm256_setzero_si256()), 
-                _mm256_packs_epi16(decision_1, _mm256_setzero_si256())));
+            v_decision[curr_state] = pack_decision_bits(decision_0, decision_1);
+
+            // Flag merges where the difference between both paths is within the margin threshold
+            if constexpr(is_reliability) {
+                const __m256i margin_0 = _mm256_subs_epu16(_mm256_max_epu16(next_error_0_0, next_error_1_0), min_next_error_0);
+                const __m256i margin_1 = _mm256_subs_epu16(_mm256_max_epu16(next_error_0_1, next_error_1_1), min_next_error_1);
+                const __m256i ambiguous_0 = _mm256_cmpeq_epi16(_mm256_subs_epu16(margin_0, margin_threshold), _mm256_setzero_si256());
+                const __m256i ambiguous_1 = _mm256_cmpeq_epi16(_mm256_subs_epu16(margin_1, margin_threshold), _mm256_setzero_si256());
+                v_ambiguity[curr_state] = pack_decision_bits(ambiguous_0, ambiguous_1);
+            }
+        }
+    }
+
+    /// @brief Process R symbols for a head or tail stage of a terminated frame.
+    ///        Head stage t only reaches the first 2^t states from state 0 so the blocks past these are skipped.
+    ///        Tail stages only take the input bit 0 branch.
+    static void bfly_pruned(
+        Base& base, const int16_t* symbols, decision_bits_t* decision, uint16_t* old_metric, uint16_t* new_metric, 
+        const size_t decoded_bit
+    ) {
+        if (decoded_bit >= Base::TOTAL_STATE_BITS) {
+            bfly<false, true>(base, symbols, decision, old_metric, new_metric);
+            return;
+        }
+
+        constexpr size_t TOTAL_LANES = SIMD_ALIGN/sizeof(uint16_t);
+        const size_t total_reachable_states = size_t(1u) << decoded_bit;
+        const size_t total_reachable_blocks = (total_reachable_states + TOTAL_LANES-1u) / TOTAL_LANES;
+        const size_t total_blocks = (total_reachable_blocks < v_stride_branch_table) ? total_reachable_blocks : v_stride_branch_table;
+        bfly(base, symbols, decision, old_metric, new_metric, nullptr, total_blocks);
+
+        __m256i* v_new_metrics = reinterpret_cast<__m256i*>(new_metric);
+        uint32_t* v_decision = reinterpret_cast<uint32_t*>(decision);
+        const __m256i unreachable_error = _mm256_set1_epi16(base.get_unreachable_error());
+        for (size_t curr_state = total_blocks; curr_state < v_stride_branch_table; curr_state++) {
+            v_new_metrics[(curr_state << 1) | 0] = unreachable_error;
+            v_new_metrics[(curr_state << 1) | 1] = unreachable_error;
+            v_decision[curr_state] = 0u;
         }
     }
 
@@ -168,5 +185,63 @@ private:
 
         return min;
     }
+
+    /// @brief Pack each set of decisions into 8 8-bit bytes, then interleave them and compress into 16 bits
+    static uint32_t pack_decision_bits(const __m256i decision_0, const __m256i decision_1) {
+        // 256bit packs works with 128bit segments
+        // 256bit unpack works with 128bit segments
+        // | = 128bit boundary
+        // packs_16  : d0 .... 0 .... | d1 .... 0 ....
+        // packs_16  : d2 .... 0 .... | d3 .... 0 ....
+        // unpacklo_8: d0 d2 d0 d2 .. | d1 d3 d1 d3 ..
+        // movemask_8: b0 b2 b0 b2 .. | b1 b3 b1 b3 ..
+        return uint32_t(_mm256_movemask_epi8(_mm256_unpacklo_epi8(
+            _mm256_packs_epi16(decision_0, _mm256_setzero_si256()), 
+            _mm256_packs_epi16(decision_1, _mm256_setzero_si256()))));
+    }
 };
 
+template <size_t constraint_length, size_t code_rate, typename observer_t>
+template <typename sum_error_t>
+sum_error_t ViterbiDecoder_AVX_u16<constraint_length,code_rate,observer_t>::update(Base& base, const int16_t* symbols, const size_t N) {
+    static_assert(is_valid, "Insufficient constraint length for vectorisation");
+    static_assert(Base::Metrics::ALIGNMENT % SIMD_ALIGN == 0);
+    static_assert(Base::BranchTable::ALIGNMENT % SIMD_ALIGN == 0);
+
+    // number of symbols must be a multiple of the code rate
+    assert(N % Base::R == 0);
+    const size_t total_decoded_bits = N / Base::R;
+    const size_t max_decoded_bits = base.get_traceback_length() + Base::TOTAL_STATE_BITS;
+    assert((total_decoded_bits + base.m_current_decoded_bit) <= max_decoded_bits);
+
+    sum_error_t total_error = 0;
+    for (size_t s = 0; s < N; s+=Base::R) {
+        auto* decision = base.m_decisions[base.m_current_decoded_bit];
+        auto* old_metric = base.m_metrics.get_old();
+        auto* new_metric = base.m_metrics.get_new();
+        if (base.get_reliability_length() > 0) {
+            auto* ambiguity = base.get_ambiguity_bits(base.m_current_decoded_bit);
+            bfly<true>(base, &symbols[s], decision, old_metric, new_metric, ambiguity);
+        } else if (base.is_pruned_stage(base.m_current_decoded_bit)) {
+            bfly_pruned(base, &symbols[s], decision, old_metric, new_metric, base.m_current_decoded_bit);
+        } else {
+            bfly(base, &symbols[s], decision, old_metric, new_metric);
+        }
+        base.m_observer.on_stage(new_metric, Base::NUMSTATES);
+        if (new_metric[0] >= base.m_config.renormalisation_threshold) {
+            const auto min_error = renormalise(new_metric);
+            base.m_observer.on_renormalise(min_error);
+            total_error += sum_error_t(min_error);
+        }
+        base.m_metrics.swap();
+        base.m_current_decoded_bit++;
+    }
+    return total_error;
+}
+
+#if defined(VITERBI_PRECOMPILED)
+#include "../viterbi_precompiled.h"
+#define __VITERBI_EXTERN_AVX_U16(K,R) VITERBI_PRECOMPILED_INSTANTIATE(extern, K, R, uint16_t, int16_t, ViterbiDecoder_AVX_u16<K,R>)
+VITERBI_PRECOMPILED_CODES_K_MIN_6(__VITERBI_EXTERN_AVX_U16)
+#undef __VITERBI_EXTERN_AVX_U16
+#endif
@@ -4,6 +4,11 @@
  * 
  * Modified by author, William Yang
  * 07/2023 - Generalised decoder using SSE4.1 instructions for 16bit types giving 8 way speedup.
+ * 10/2026 - Moved update() out of the class body so it can be explicitly instantiated by the precompiled library.
+ * 10/2026 - Befriended ViterbiDecoder_KernelAccess so bfly() and renormalise() can be benchmarked in isolation.
+ * 10/2026 - Added observer template parameter which is notified of each decoded bit and renormalisation.
+ * 10/2026 - Optionally flag merges within a margin threshold as ambiguous for the reliability check.
+ * 10/2026 - Skip unreachable blocks of states and the input bit 1 branch in the head and tail of terminated frames.
  */
 #pragma once
 #include "../viterbi_decoder_core.h"
@@ -16,11 +21,11 @@
 /// @brief Vectorisation using SSE4.1
 ///        16bit integers for errors, soft-decision values.
 ///        8 way vectorisation from 128bits/16bits.
-template <size_t constraint_length, size_t code_rate>
+template <size_t constraint_length, size_t code_rate, typename observer_t = ViterbiDecoder_NullObserver>
 class ViterbiDecoder_SSE_u16
 {
 private:
-    using Base = ViterbiDecoder_Core<constraint_length,code_rate,uint16_t,int16_t>;
+    using Base = ViterbiDecoder_Core<constraint_length,code_rate,uint16_t,int16_t,observer_t>;
     using decision_bits_t = typename Base::Decisions::format_t;
 private:
     // Calculate the minimum constraint length for vectorisation
@@ -43,37 +48,20 @@ public:
     static constexpr bool is_valid = Base::K >= K_min;
 
     template <typename sum_error_t>
-    static sum_error_t update(Base& base, const int16_t* symbols, const size_t N) {
-        static_assert(is_valid, "Insufficient constraint length for vectorisation");
-        static_assert(Base::Metrics::ALIGNMENT % SIMD_ALIGN == 0);
-        static_assert(Base::BranchTable::ALIGNMENT % SIMD_ALIGN == 0);
-
-        // number of symbols must be a multiple of the code rate
-        assert(N % Base::R == 0);
-        const size_t total_decoded_bits = N / Base::R;
-        const size_t max_decoded_bits = base.get_traceback_length() + Base::TOTAL_STATE_BITS;
-        assert((total_decoded_bits + base.m_current_decoded_bit) <= max_decoded_bits);
-
-        sum_error_t total_error = 0;
-        for (size_t s = 0; s < N; s+=Base::R) {
-            auto* decision = base.m_decisions[base.m_current_decoded_bit];
-            auto* old_metrics = base.m_metrics.get_old();
-            auto* new_metrics = base.m_metrics.get_new();
-            bfly(base, &symbols[s], decision, old_metrics, new_metrics);
-            if (new_metrics[0] >= base.m_config.renormalisation_threshold) {
-                total_error += sum_error_t(renormalise(new_metrics));
-            }
-            base.m_metrics.swap();
-            base.m_current_decoded_bit++;
-        }
-        return total_error;
-    }
+    static sum_error_t update(Base& base, const int16_t* symbols, const size_t N);
 private:
-    static void bfly(Base& base, const int16_t* symbols, decision_bits_t* decision, uint16_t* old_metrics, uint16_t* new_metrics) {
+    template <class> friend struct ViterbiDecoder_KernelAccess;
+
+    template <bool is_reliability = false, bool is_zero_input = false>
+    static void bfly(
+        Base& base, const int16_t* symbols, decision_bits_t* decision, uint16_t* old_metrics, uint16_t* new_metrics, 
+        decision_bits_t* ambiguity = nullptr, const size_t total_blocks = v_stride_branch_table
+    ) {
         const __m128i* v_branch_table = reinterpret_cast<const __m128i*>(base.m_branch_table.data());
         __m128i* v_old_metrics = reinterpret_cast<__m128i*>(old_metrics);
         __m128i* v_new_metrics = reinterpret_cast<__m128i*>(new_metrics);
         uint16_t* v_decision = reinterpret_cast<uint16_t*>(decision);
+        [[maybe_unused]] uint16_t* v_ambiguity = reinterpret_cast<uint16_t*>(ambiguity);
 
         assert(uintptr_t(v_branch_table) % SIMD_ALIGN == 0);
         assert(uintptr_t(v_old_metrics)  % SIMD_ALIGN == 0);
@@ -86,8 +74,10 @@ private:
             v_symbols[i] = _mm_set1_epi16(symbols[i]);
         }
         const __m128i max_error = _mm_set1_epi16(base.m_config.soft_decision_max_error);
+        [[maybe_unused]] const __m128i margin_threshold = _mm_set1_epi16(base.get_margin_threshold());
+        [[maybe_unused]] const __m128i unreachable_error = _mm_set1_epi16(base.get_unreachable_error());
 
-        for (size_t curr_state = 0u; curr_state < v_stride_branch_table; curr_state++) {
+        for (size_t curr_state = 0u; curr_state < total_blocks; curr_state++) {
             // Total errors across R symbols
             __m128i total_error = _mm_set1_epi16(0);
             for (size_t i = 0u; i < Base::R; i++) {
@@ -110,9 +100,9 @@ private:
             const __m128i next_error_1_1 = _mm_adds_epu16(v_old_metrics[curr_state_1],   total_error);
 
             const __m128i min_next_error_0 = _mm_min_epu16(next_error_0_0, next_error_1_0);
-            const __m128i min_next_error_1 = _mm_min_epu16(next_error_0_1, next_error_1_1);
+            const __m128i min_next_error_1 = is_zero_input ? unreachable_error : _mm_min_epu16(next_error_0_1, next_error_1_1);
             const __m128i decision_0 = _mm_cmpeq_epi16(min_next_error_0, next_error_1_0);
-            const __m128i decision_1 = _mm_cmpeq_epi16(min_next_error_1, next_error_1_1);
+            const __m128i decision_1 = is_zero_input ? _mm_setzero_si128() : _mm_cmpeq_epi16(min_next_error_1, next_error_1_1);
 
             // Update metrics
             //
@@ -130,8 +120,6 @@ private:
             v_new_metrics[next_state_0] = _mm_unpacklo_epi16(min_next_error_0, min_next_error_1);
             v_new_metrics[next_state_1] = _mm_unpackhi_epi16(min_next_error_0, min_next_error_1);
 
-            // Pack each set of decisions into 8 8-bit bytes, then interleave them and compress into 16 bits
-            // 
             // Note that the decision bits are packed so that they store 2L states 
             // But we stride L states at a time for our branch table
             // So to store the decision bits for (2i)*L and (2i+1)*L we store them in index j 
@@ -139,14 +127,44 @@ private:
             // i = curr_state,      i: 2i*L + {0..L-1} | (2i+1)*L + {0..L-1} = 2i*L + {0..2L-1}
             // j = decision_index,  j: j*2L + {0..2L-1}
             // Therefore we index using j = i = curr_state
-            //
-            // We still have to do the repacking like for the new metrics, which is done using the unpacklo
-            // packs: {d..},{0..} => {d..d,0..0} => 16bit elements get saturated into 8bit elements and concatentated
-            // unpacklo: {d0..d0,0..0},{d1..d1,0..0} => {d0,d1,d0,d1..d0,d1}
-            // movemask: Gets the most significant bit and compacts it into a bitfield
-            v_decision[curr_state] = _mm_movemask_epi8(_mm_unpacklo_epi8(
-                _mm_packs_epi16(decision_0, _mm_setzero_si128()), 
-                _mm_packs_epi16(decision_1, _mm_setzero_si128())));
+            v_decision[curr_state] = pack_decision_bits(decision_0, decision_1);
+
+            // Flag merges where the difference between both paths is within the margin threshold
+            if constexpr(is_reliability) {
+                const __m128i margin_0 = _mm_subs_epu16(_mm_max_epu16(next_error_0_0, next_error_1_0), min_next_error_0);
+                const __m128i margin_1 = _mm_subs_epu16(_mm_max_epu16(next_error_0_1, next_error_1_1), min_next_error_1);
+                const __m128i ambiguous_0 = _mm_cmpeq_epi16(_mm_subs_epu16(margin_0, margin_threshold), _mm_setzero_si128());
+                const __m128i ambiguous_1 = _mm_cmpeq_epi16(_mm_subs_epu16(margin_1, margin_threshold), _mm_setzero_si128());
+                v_ambiguity[curr_state] = pack_decision_bits(ambiguous_0, ambiguous_1);
+            }
+        }
+    }
+
+    /// @brief Process R symbols for a head or tail stage of a terminated frame.
+    ///        Head stage t only reaches the first 2^t states from state 0 so the blocks past these are skipped.
+    ///        Tail stages only take the input bit 0 branch.
+    static void bfly_pruned(
+        Base& base, const int16_t* symbols, decision_bits_t* decision, uint16_t* old_metrics, uint16_t* new_metrics, 
+        const size_t decoded_bit
+    ) {
+        if (decoded_bit >= Base::TOTAL_STATE_BITS) {
+            bfly<false, true>(base, symbols, decision, old_metrics, new_metrics);
+            return;
+        }
+
+        constexpr size_t TOTAL_LANES = SIMD_ALIGN/sizeof(uint16_t);
+        const size_t total_reachable_states = size_t(1u) << decoded_bit;
+        const size_t total_reachable_blocks = (total_reachable_states + TOTAL_LANES-1u) / TOTAL_LANES;
+        const size_t total_blocks = (total_reachable_blocks < v_stride_branch_table) ? total_reachable_blocks : v_stride_branch_table;
+        bfly(base, symbols, decision, old_metrics, new_metrics, nullptr, total_blocks);
+
+        __m128i* v_new_metrics = reinterpret_cast<__m128i*>(new_metrics);
+        uint16_t* v_decision = reinterpret_cast<uint16_t*>(decision);
+        const __m128i unreachable_error = _mm_set1_epi16(base.get_unreachable_error());
+        for (size_t curr_state = total_blocks; curr_state < v_stride_branch_table; curr_state++) {
+            v_new_metrics[(curr_state << 1) | 0] = unreachable_error;
+            v_new_metrics[(curr_state << 1) | 1] = unreachable_error;
+            v_decision[curr_state] = 0u;
         }
     }
 
@@ -176,4 +194,60 @@ private:
 
         return min;
     }
-};
\ No newline at end of file
+
+    /// @brief Pack each set of decisions into 8 8-bit bytes, then interleave them and compress into 16 bits
+    static uint16_t pack_decision_bits(const __m128i decision_0, const __m128i decision_1) {
+        // We still have to do the repacking like for the new metrics, which is done using the unpacklo
+        // packs: {d..},{0..} => {d..d,0..0} => 16bit elements get saturated into 8bit elements and concatentated
+        // unpacklo: {d0..d0,0..0},{d1..d1,0..0} => {d0,d1,d0,d1..d0,d1}
+        // movemask: Gets the most significant bit and compacts it into a bitfield
+        return uint16_t(_mm_movemask_epi8(_mm_unpacklo_epi8(
+            _mm_packs_epi16(decision_0, _mm_setzero_si128()), 
+            _mm_packs_epi16(decision_1, _mm_setzero_si128()))));
+    }
+};
+
+template <size_t constraint_length, size_t code_rate, typename observer_t>
+template <typename sum_error_t>
+sum_error_t ViterbiDecoder_SSE_u16<constraint_length,code_rate,observer_t>::update(Base& base, const int16_t* symbols, const size_t N) {
+    static_assert(is_valid, "Insufficient constraint length for vectorisation");
+    static_assert(Base::Metrics::ALIGNMENT % SIMD_ALIGN == 0);
+    static_assert(Base::BranchTable::ALIGNMENT % SIMD_ALIGN == 0);
+
+    // number of symbols must be a multiple of the code rate
+    assert(N % Base::R == 0);
+    const size_t total_decoded_bits = N / Base::R;
+    const size_t max_decoded_bits = base.get_traceback_length() + Base::TOTAL_STATE_BITS;
+    assert((total_decoded_bits + base.m_current_decoded_bit) <= max_decoded_bits);
+
+    sum_error_t total_error = 0;
+    for (size_t s = 0; s < N; s+=Base::R) {
+        auto* decision = base.m_decisions[base.m_current_decoded_bit];
+        auto* old_metrics = base.m_metrics.get_old();
+        auto* new_metrics = base.m_metrics.get_new();
+        if (base.get_reliability_length() > 0) {
+            auto* ambiguity = base.get_ambiguity_bits(base.m_current_decoded_bit);
+            bfly<true>(base, &symbols[s], decision, old_metrics, new_metrics, ambiguity);
+        } else if (base.is_pruned_stage(base.m_current_decoded_bit)) {
+            bfly_pruned(base, &symbols[s], decision, old_metrics, new_metrics, base.m_current_decoded_bit);
+        } else {
+            bfly(base, &symbols[s], decision, old_metrics, new_metrics);
+        }
+        base.m_observer.on_stage(new_metrics, Base::NUMSTATES);
+        if (new_metrics[0] >= base.m_config.renormalisation_threshold) {
+            const auto min_error = renormalise(new_metrics);
+            base.m_observer.on_renormalise(min_error);
+            total_error += sum_error_t(min_error);
+        }
+        base.m_metrics.swap();
+        base.m_current_decoded_bit++;
+    }
+    return total_error;
+}
+
+#if defined(VITERBI_PRECOMPILED)
+#include "../viterbi_precompiled.h"
+#define __VITERBI_EXTERN_SSE_U16(K,R) VITERBI_PRECOMPILED_INSTANTIATE(extern, K, R, uint16_t, int16_t, ViterbiDecoder_SSE_u16<K,R>)
+VITERBI_PRECOMPILED_CODES_K_MIN_5(__VITERBI_EXTERN_SSE_U16)
+#undef __VITERBI_EXTERN_SSE_U16
+#endif
@@ -0,0 +1,12 @@
+// Explicit instantiations of NEON decoders for the common codes
+#include "viterbi/arm/viterbi_decoder_neon_u16.h"
+#include "viterbi/arm/viterbi_decoder_neon_u8.h"
+#include "viterbi/viterbi_precompiled.h"
+
+// Shared data structures are instantiated in precompiled_scalar.cpp so no copies built with this instruction set leak out
+VITERBI_PRECOMPILED_EXTERN_CORE()
+
+#define INSTANTIATE_NEON_U16(K,R) VITERBI_PRECOMPILED_INSTANTIATE(, K, R, uint16_t, int16_t, ViterbiDecoder_NEON_u16<K,R>)
+#define INSTANTIATE_NEON_U8(K,R)  VITERBI_PRECOMPILED_INSTANTIATE(, K, R, uint8_t,  int8_t,  ViterbiDecoder_NEON_u8<K,R>)
+VITERBI_PRECOMPILED_CODES_K_MIN_5(INSTANTIATE_NEON_U16)
+VITERBI_PRECOMPILED_CODES_K_MIN_6(INSTANTIATE_NEON_U8)
@@ -0,0 +1,16 @@
+// Explicit instantiations of scalar decoders for the common codes
+#include "viterbi/viterbi_decoder_scalar.h"
+#include "viterbi/viterbi_precompiled.h"
+
+#define INSTANTIATE_SCALAR_U16(K,R) VITERBI_PRECOMPILED_INSTANTIATE(, K, R, uint16_t, int16_t, ViterbiDecoder_Scalar<K,R,uint16_t,int16_t>)
+#define INSTANTIATE_SCALAR_U8(K,R)  VITERBI_PRECOMPILED_INSTANTIATE(, K, R, uint8_t,  int8_t,  ViterbiDecoder_Scalar<K,R,uint8_t,int8_t>)
+VITERBI_PRECOMPILED_CODES_K_MIN_2(INSTANTIATE_SCALAR_U16)
+VITERBI_PRECOMPILED_CODES_K_MIN_2(INSTANTIATE_SCALAR_U8)
+
+// Data structures shared with the vectorised decoders are only compiled here without any extra instruction sets
+#define INSTANTIATE_CORE_U16(K,R) VITERBI_PRECOMPILED_INSTANTIATE_CORE(, K, R, uint16_t, int16_t)
+#define INSTANTIATE_CORE_U8(K,R)  VITERBI_PRECOMPILED_INSTANTIATE_CORE(, K, R, uint8_t,  int8_t)
+#define INSTANTIATE_CORE_K(K)     VITERBI_PRECOMPILED_INSTANTIATE_CORE_K(, K)
+VITERBI_PRECOMPILED_CODES_K_MIN_2(INSTANTIATE_CORE_U16)
+VITERBI_PRECOMPILED_CODES_K_MIN_2(INSTANTIATE_CORE_U8)
+VITERBI_PRECOMPILED_CONSTRAINT_LENGTHS(INSTANTIATE_CORE_K)
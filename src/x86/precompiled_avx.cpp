@@ -0,0 +1,13 @@
+// Explicit instantiations of AVX2 decoders for the common codes
+// NOTE: This translation unit must be compiled with AVX2 enabled
+#include "viterbi/x86/viterbi_decoder_avx_u16.h"
+#include "viterbi/x86/viterbi_decoder_avx_u8.h"
+#include "viterbi/viterbi_precompiled.h"
+
+// Shared data structures are instantiated in precompiled_scalar.cpp so no copies built with this instruction set leak out
+VITERBI_PRECOMPILED_EXTERN_CORE()
+
+#define INSTANTIATE_AVX_U16(K,R) VITERBI_PRECOMPILED_INSTANTIATE(, K, R, uint16_t, int16_t, ViterbiDecoder_AVX_u16<K,R>)
+#define INSTANTIATE_AVX_U8(K,R)  VITERBI_PRECOMPILED_INSTANTIATE(, K, R, uint8_t,  int8_t,  ViterbiDecoder_AVX_u8<K,R>)
+VITERBI_PRECOMPILED_CODES_K_MIN_6(INSTANTIATE_AVX_U16)
+VITERBI_PRECOMPILED_CODES_K_MIN_7(INSTANTIATE_AVX_U8)
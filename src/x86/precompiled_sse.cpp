@@ -0,0 +1,13 @@
+// Explicit instantiations of SSE4.1 decoders for the common codes
+// NOTE: This translation unit must be compiled with SSE4.1 enabled
+#include "viterbi/x86/viterbi_decoder_sse_u16.h"
+#include "viterbi/x86/viterbi_decoder_sse_u8.h"
+#include "viterbi/viterbi_precompiled.h"
+
+// Shared data structures are instantiated in precompiled_scalar.cpp so no copies built with this instruction set leak out
+VITERBI_PRECOMPILED_EXTERN_CORE()
+
+#define INSTANTIATE_SSE_U16(K,R) VITERBI_PRECOMPILED_INSTANTIATE(, K, R, uint16_t, int16_t, ViterbiDecoder_SSE_u16<K,R>)
+#define INSTANTIATE_SSE_U8(K,R)  VITERBI_PRECOMPILED_INSTANTIATE(, K, R, uint8_t,  int8_t,  ViterbiDecoder_SSE_u8<K,R>)
+VITERBI_PRECOMPILED_CODES_K_MIN_5(INSTANTIATE_SSE_U16)
+VITERBI_PRECOMPILED_CODES_K_MIN_6(INSTANTIATE_SSE_U8)
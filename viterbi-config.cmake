@@ -3,4 +3,31 @@ project(viterbi)
 
 add_library(viterbi INTERFACE)
 target_include_directories(viterbi INTERFACE ${CMAKE_CURRENT_LIST_DIR}/include)
-target_compile_features(viterbi INTERFACE cxx_std_17)
\ No newline at end of file
+target_compile_features(viterbi INTERFACE cxx_std_17)
+
+# Optional static library with explicit instantiations of the decoders for the common codes
+# Consumers that link against it get extern template declarations and skip compiling these kernels
+option(VITERBI_BUILD_PRECOMPILED "Build viterbi_precompiled library for common codes" OFF)
+if(VITERBI_BUILD_PRECOMPILED)
+    set(VITERBI_SRC_DIR ${CMAKE_CURRENT_LIST_DIR}/src)
+    add_library(viterbi_precompiled STATIC ${VITERBI_SRC_DIR}/precompiled_scalar.cpp)
+    target_link_libraries(viterbi_precompiled PUBLIC viterbi)
+    target_compile_definitions(viterbi_precompiled INTERFACE VITERBI_PRECOMPILED)
+
+    # Each instruction set is compiled in its own object file with the flags it requires
+    # Shared data structures are instantiated in precompiled_scalar.cpp without these flags, but inline templates from
+    # the standard library can still be emitted by these object files so consumers should target the same instruction set
+    if(CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64|i.86|x86)$")
+        set(VITERBI_SRC_SSE ${VITERBI_SRC_DIR}/x86/precompiled_sse.cpp)
+        set(VITERBI_SRC_AVX ${VITERBI_SRC_DIR}/x86/precompiled_avx.cpp)
+        target_sources(viterbi_precompiled PRIVATE ${VITERBI_SRC_SSE} ${VITERBI_SRC_AVX})
+        if(MSVC)
+            set_source_files_properties(${VITERBI_SRC_AVX} PROPERTIES COMPILE_OPTIONS "/arch:AVX2")
+        else()
+            set_source_files_properties(${VITERBI_SRC_SSE} PROPERTIES COMPILE_OPTIONS "-msse4.2")
+            set_source_files_properties(${VITERBI_SRC_AVX} PROPERTIES COMPILE_OPTIONS "-mavx2")
+        endif()
+    elseif(CMAKE_SYSTEM_PROCESSOR MATCHES "^(aarch64|arm64|ARM64)$")
+        target_sources(viterbi_precompiled PRIVATE ${VITERBI_SRC_DIR}/arm/precompiled_neon.cpp)
+    endif()
+endif()